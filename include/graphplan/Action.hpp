@@ -66,9 +66,6 @@ namespace graphplan
     /// get preconditions
     const std::set<Proposition>& get_preconditions() const;
 
-    /// check if this is a maintenance action
-    bool is_maintenance_action() const;
-
     /// get string version
     std::string to_string() const;
 
@@ -32,40 +32,29 @@
 #ifndef _GRAPHPLAN_ACTION_NODE_HPP_
 #define _GRAPHPLAN_ACTION_NODE_HPP_
 
-#include <set>
+#include <string>
 
 #include "graphplan/Action.hpp"
 
 namespace graphplan
 {
-  class Proposition_Node;
-
   class Action_Node
   {
   public:
-    /// Constructor
-    Action_Node(const Action& n);
+    /// bit set in the ids of no-op actions, the rest is the literal id
+    static const unsigned int NOOP = 1u << 31;
+
+    /// Constructor, action must outlive the node
+    Action_Node(const Action& n, unsigned int id = 0, unsigned int level = 0);
 
     /// get base action
     const Action& get_action() const;
 
-    /// get precondition list
-    void add_precondition(Proposition_Node* p);
-
-    /// get add list
-    void add_effect(Proposition_Node* p);
-
-    /// get mutex list
-    void add_mutex(Action_Node* a);
+    /// get id of base action in the action table
+    unsigned int get_id() const;
 
-    /// get precondition list
-    const std::set<Proposition_Node*>& get_preconditions() const;
-
-    /// get effects
-    const std::set<Proposition_Node*>& get_effects() const;
-
-    /// get mutex list
-    const std::set<Action_Node*>& get_mutex() const;
+    /// get first level this node is in
+    unsigned int get_level() const;
 
     /// get name of action
     std::string get_name() const;
@@ -73,19 +62,35 @@ namespace graphplan
     /// instance of Action
     bool is_instance_of (const Action& a) const;
 
-  protected:
-    /// name of the proposition
-    const Action action_;
+    /// get id of the no-op that carries a literal id of the compiled
+    /// problem to the next level
+    static unsigned int noop_id(unsigned int literal);
 
-    /// preconditions
-    std::set<Proposition_Node*> preconditions_;
+    /// determine if an action id is a no-op
+    static bool is_noop(unsigned int id);
 
-    /// results
-    std::set<Proposition_Node*> effects_;
+  protected:
+    /// shared action this node is an instance of
+    const Action* action_;
+
+    /// id of action in the action table
+    unsigned int id_;
 
-    /// mutex
-    std::set<Action_Node*> mutex_;
+    /// first level this node is in, it is in every level after
+    unsigned int level_;
   }; // class Action_Node
+
+  inline unsigned int
+  Action_Node::noop_id(unsigned int literal)
+  {
+    return NOOP | literal;
+  }
+
+  inline bool
+  Action_Node::is_noop(unsigned int id)
+  {
+    return (id & NOOP) != 0;
+  }
 } // namespace graphplan
 
 #endif // _GRAPHPLAN_ACTION_NODE_HPP_
@@ -0,0 +1,86 @@
+/**
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2014 Anton Dukeman
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * @file Atom_Table.hpp
+ * @author Anton Dukeman <anton.dukeman@gmail.com>
+ *
+ * Symbol table interning proposition names to integer ids, only names are
+ * kept here, a compiled problem numbers its own atoms densely
+ */
+
+#ifndef _GRAPHPLAN_ATOM_TABLE_H_
+#define _GRAPHPLAN_ATOM_TABLE_H_
+
+#include <string>
+#include <unordered_map>
+#include <mutex>
+#include <atomic>
+
+namespace graphplan
+{
+  class Atom_Table
+  {
+  public:
+    /// get the process wide table
+    static Atom_Table& instance();
+
+    /// get id for name, adding it if not present
+    unsigned int intern(const std::string& name);
+
+    /// get name of an interned id, without locking
+    const std::string& get_name(unsigned int id) const;
+
+    /// get number of interned names, without locking
+    unsigned int size() const;
+
+  protected:
+    /// number of blocks of names, block b holds 2^b names
+    static const unsigned int BLOCKS = 32;
+
+    /// Constructor
+    Atom_Table();
+
+    /// Destructor
+    ~Atom_Table();
+
+    /// get block holding id and the position of id in it
+    static unsigned int block_of(unsigned int id, unsigned int& offset);
+
+    /// ids of interned names
+    std::unordered_map<std::string, unsigned int> ids_;
+
+    /// names by id in blocks that never move once allocated, so readers
+    /// need no lock and references stay valid as the table grows
+    std::atomic<std::string*> blocks_[BLOCKS];
+
+    /// number of interned names
+    std::atomic<unsigned int> size_;
+
+    /// guards interning
+    std::mutex lock_;
+  }; // class Atom_Table
+} // namespace graphplan
+
+#endif // _GRAPHPLAN_ATOM_TABLE_H_
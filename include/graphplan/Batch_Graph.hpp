@@ -0,0 +1,203 @@
+/**
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2014 Anton Dukeman
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * @file Batch_Graph.hpp
+ * @author Anton Dukeman <anton.dukeman@gmail.com>
+ *
+ * Planning graph of up to 64 problems that share actions and goals but start
+ * in different states, each node and mutex pair holds one bit per problem
+ */
+
+#ifndef _GRAPHPLAN_BATCH_GRAPH_H_
+#define _GRAPHPLAN_BATCH_GRAPH_H_
+
+#include <vector>
+#include <set>
+#include <cstdint>
+
+#include "graphplan/Proposition.hpp"
+#include "graphplan/Action.hpp"
+#include "graphplan/Edge_Table.hpp"
+#include "graphplan/Compiled_Problem.hpp"
+
+namespace graphplan
+{
+  class Batch_Graph
+  {
+  public:
+    /// one bit per problem, the lane of the problem
+    typedef std::uint64_t Lanes;
+
+    /// most problems in one batch
+    static const unsigned int LANES = 64;
+
+    /// returned for a full batch and for levels never reached
+    static const unsigned int npos = ~0u;
+
+    /// build levels without a bound on their number
+    static const unsigned int NO_LIMIT = ~0u;
+
+    /// Constructor
+    Batch_Graph();
+
+    /// add possible action shared by every problem
+    void add_action(const Action& a);
+
+    /// add goal proposition shared by every problem
+    void add_goal(const Proposition& p);
+
+    /// add a problem starting in starting, returns its lane or npos if the
+    /// batch is full
+    unsigned int add_instance(const std::set<Proposition>& starting);
+
+    /// treat atoms not in a starting state as false and negated effects as
+    /// deletes, as Graphplan::set_closed_world does
+    void set_closed_world(bool closed = true);
+
+    /// check if negated effects are deletes
+    bool is_closed_world() const;
+
+    /// get number of problems added
+    unsigned int get_instance_count() const;
+
+    /// build levels from the starting states until every problem has its
+    /// goals in a level or has leveled off without them, returns the
+    /// number of levels built
+    unsigned int expand(unsigned int iterations = NO_LIMIT);
+
+    /// get first level of a lane with every goal and no two goals mutex,
+    /// where Graphplan starts searching, npos if none was built
+    unsigned int get_goal_level(unsigned int lane) const;
+
+    /// get first level of a lane identical to every level after it, npos if
+    /// the lane has not leveled off in the levels built
+    unsigned int get_leveled_off(unsigned int lane) const;
+
+    /// get lanes with p in the last level built
+    Lanes get_reached(const Proposition& p) const;
+
+    /// get lanes with a and b mutex in the last level built
+    Lanes get_mutex(const Proposition& a, const Proposition& b) const;
+
+  protected:
+    /// literal ids read or written by an action
+    typedef Edge_Table<unsigned int> Literal_Table;
+
+    /// index of an unordered pair of different ids in a triangular table
+    static std::size_t pair(unsigned int i, unsigned int j);
+
+    /// lanes with literal ids i and j mutex in prop_mutex_
+    Lanes prop_mutex(unsigned int i, unsigned int j) const;
+
+    /// compile actions and goals and find the state invariants of each lane
+    void compile();
+
+    /// build the level after level, one lane per bit
+    void iteration(unsigned int level);
+
+    /// set the goal level of lanes with the goals in level, returns the
+    /// lanes with nothing left to build
+    Lanes goal_check(unsigned int level);
+
+    /// starting propositions of each lane
+    std::vector<std::set<Proposition> > starting_;
+
+    /// goal propositions
+    std::set<Proposition> goals_;
+
+    /// available actions
+    std::set<Action> actions_;
+
+    /// whether negated effects are deletes rather than stored literals
+    bool closed_world_;
+
+    /// actions, stored literals and interference shared by every lane
+    Compiled_Problem problem_;
+
+    /// lanes holding a problem
+    Lanes instances_;
+
+    /// each literal id, read by the no-op that carries it
+    std::vector<unsigned int> literal_ids_;
+
+    /// literal ids read by each action index, real actions their
+    /// preconditions and no-ops their one literal
+    std::vector<Literal_Table::Range> reads_;
+
+    /// lanes in which each pair of literal ids is in one state invariant
+    std::vector<Lanes> invariant_;
+
+    /// lanes with each literal id in the last level
+    std::vector<Lanes> reached_;
+
+    /// lanes with each action index in the last action level
+    std::vector<Lanes> applied_;
+
+    /// lanes with each pair of literal ids mutex in the last level
+    std::vector<Lanes> prop_mutex_;
+
+    /// lanes with each pair of action indices mutex in the last action level
+    std::vector<Lanes> action_mutex_;
+
+    /// lanes of the level being built, swapped with the ones above so each
+    /// level reuses the buffers of the level two before it
+    std::vector<Lanes> next_applied_;
+
+    /// lanes of the literals of the level being built
+    std::vector<Lanes> next_reached_;
+
+    /// lanes of the literal pairs of the level being built
+    std::vector<Lanes> next_prop_mutex_;
+
+    /// lanes of the action pairs of the level being built
+    std::vector<Lanes> next_action_mutex_;
+
+    /// action indices that could have created each literal id in the level
+    /// being built, the rows keep their storage from level to level
+    std::vector<std::vector<unsigned int> > supporters_;
+
+    /// goal level of each lane
+    std::vector<unsigned int> goal_level_;
+
+    /// leveled off level of each lane
+    std::vector<unsigned int> leveled_off_;
+  }; // class Batch_Graph
+
+  inline std::size_t
+  Batch_Graph::pair(unsigned int i, unsigned int j)
+  {
+    if(i < j)
+      return pair(j, i);
+    return std::size_t(i) * (i - 1) / 2 + j;
+  }
+
+  inline Batch_Graph::Lanes
+  Batch_Graph::prop_mutex(unsigned int i, unsigned int j) const
+  {
+    return i == j ? 0 : prop_mutex_[pair(i, j)];
+  }
+} // namespace graphplan
+
+#endif // _GRAPHPLAN_BATCH_GRAPH_H_
@@ -0,0 +1,116 @@
+/**
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2014 Anton Dukeman
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * @file Bit_Kernels.hpp
+ * @author Anton Dukeman <anton.dukeman@gmail.com>
+ *
+ * Subset, intersection and population count over word arrays, vectorized
+ * for the instruction sets the running CPU supports
+ */
+
+#ifndef _GRAPHPLAN_BIT_KERNELS_H_
+#define _GRAPHPLAN_BIT_KERNELS_H_
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+namespace graphplan
+{
+  /// one implementation of every kernel
+  struct Bit_Kernels
+  {
+    /// storage word
+    typedef std::uint64_t Word;
+
+    /// test on two arrays of the same number of words
+    typedef bool (*Test)(const Word* a, const Word* b, std::size_t words);
+
+    /// count on one array
+    typedef std::size_t (*Count)(const Word* a, std::size_t words);
+
+    /// arrays shorter than this are handled inline, the call costs more
+    static const std::size_t MIN_WORDS = 8;
+
+    /// instruction set name
+    const char* name;
+
+    /// check if every bit set in a is set in b
+    Test is_subset;
+
+    /// check if any bit is set in both
+    Test intersects;
+
+    /// count set bits
+    Count count;
+
+    /// get the fastest kernels the running CPU supports, found by CPUID on
+    /// first use
+    static const Bit_Kernels& best();
+
+    /// get every implementation the running CPU supports, portable first
+    static std::vector<const Bit_Kernels*> supported();
+  };
+
+  /// check if every bit set in a is set in b
+  inline bool
+  words_subset(const Bit_Kernels::Word* a, const Bit_Kernels::Word* b,
+    std::size_t words)
+  {
+    if(words >= Bit_Kernels::MIN_WORDS)
+      return Bit_Kernels::best().is_subset(a, b, words);
+    for(std::size_t k = 0; k < words; ++k)
+      if(a[k] & ~b[k])
+        return false;
+    return true;
+  }
+
+  /// check if any bit is set in both
+  inline bool
+  words_intersect(const Bit_Kernels::Word* a, const Bit_Kernels::Word* b,
+    std::size_t words)
+  {
+    if(words >= Bit_Kernels::MIN_WORDS)
+      return Bit_Kernels::best().intersects(a, b, words);
+    for(std::size_t k = 0; k < words; ++k)
+      if(a[k] & b[k])
+        return true;
+    return false;
+  }
+
+  /// count set bits
+  inline std::size_t
+  words_count(const Bit_Kernels::Word* a, std::size_t words)
+  {
+    if(words >= Bit_Kernels::MIN_WORDS)
+      return Bit_Kernels::best().count(a, words);
+    std::size_t ret = 0;
+    for(std::size_t k = 0; k < words; ++k)
+      ret += __builtin_popcountll(a[k]);
+    return ret;
+  }
+} // namespace graphplan
+
+#endif // _GRAPHPLAN_BIT_KERNELS_H_
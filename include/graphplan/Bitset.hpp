@@ -0,0 +1,139 @@
+/**
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2014 Anton Dukeman
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * @file Bitset.hpp
+ * @author Anton Dukeman <anton.dukeman@gmail.com>
+ *
+ * Dense dynamically sized bitset used for proposition layers
+ */
+
+#ifndef _GRAPHPLAN_BITSET_H_
+#define _GRAPHPLAN_BITSET_H_
+
+#include <vector>
+#include <cstdint>
+
+namespace graphplan
+{
+  class Bitset
+  {
+  public:
+    /// storage word
+    typedef std::uint64_t Word;
+
+    /// bits per storage word
+    static const unsigned int WORD_BITS = 64;
+
+    /// returned by find functions when there are no more bits
+    static const unsigned int npos = ~0u;
+
+    /// Constructor
+    Bitset(unsigned int n = 0);
+
+    /// resize, keeping existing bits
+    void resize(unsigned int n);
+
+    /// get number of bits
+    unsigned int size() const;
+
+    /// set bit, growing if needed
+    void set(unsigned int i);
+
+    /// clear bit
+    void reset(unsigned int i);
+
+    /// test bit, bits past the end are clear
+    bool test(unsigned int i) const;
+
+    /// clear all bits
+    void clear();
+
+    /// check if any bit is set
+    bool any() const;
+
+    /// count set bits
+    unsigned int count() const;
+
+    /// check if every bit set here is also set in b
+    bool is_subset_of(const Bitset& b) const;
+
+    /// check if any bit is set in both
+    bool intersects(const Bitset& b) const;
+
+    /// union
+    Bitset& operator|=(const Bitset& b);
+
+    /// intersection
+    Bitset& operator&=(const Bitset& b);
+
+    /// equality operator, ignores trailing clear bits
+    bool operator==(const Bitset& b) const;
+
+    /// inequality operator
+    bool operator!=(const Bitset& b) const;
+
+    /// get first set bit or npos
+    unsigned int find_first() const;
+
+    /// get first set bit after i or npos
+    unsigned int find_next(unsigned int i) const;
+
+    /// get storage words
+    const Word* data() const;
+
+    /// get number of storage words
+    unsigned int word_count() const;
+
+  protected:
+    /// number of bits
+    unsigned int size_;
+
+    /// storage
+    std::vector<Word> words_;
+  }; // class Bitset
+
+  inline void
+  Bitset::set(unsigned int i)
+  {
+    if(i >= size_)
+      resize(i + 1);
+    words_[i / WORD_BITS] |= Word(1) << (i % WORD_BITS);
+  }
+
+  inline void
+  Bitset::reset(unsigned int i)
+  {
+    if(i < size_)
+      words_[i / WORD_BITS] &= ~(Word(1) << (i % WORD_BITS));
+  }
+
+  inline bool
+  Bitset::test(unsigned int i) const
+  {
+    return i < size_ && (words_[i / WORD_BITS] >> (i % WORD_BITS)) & 1;
+  }
+} // namespace graphplan
+
+#endif // _GRAPHPLAN_BITSET_H_
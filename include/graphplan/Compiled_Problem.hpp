@@ -0,0 +1,122 @@
+/**
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2014 Anton Dukeman
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * @file Compiled_Problem.hpp
+ * @author Anton Dukeman <anton.dukeman@gmail.com>
+ *
+ * Actions and literals of a problem compiled to integer tables, shared by
+ * Graphplan and Batch_Graph, the atoms of a problem are numbered densely so
+ * its tables only grow with the problem
+ */
+
+#ifndef _GRAPHPLAN_COMPILED_PROBLEM_H_
+#define _GRAPHPLAN_COMPILED_PROBLEM_H_
+
+#include <vector>
+#include <set>
+#include <string>
+
+#include "graphplan/Proposition.hpp"
+#include "graphplan/Action.hpp"
+#include "graphplan/Bitset.hpp"
+#include "graphplan/Mutex_Matrix.hpp"
+#include "graphplan/Edge_Table.hpp"
+
+namespace graphplan
+{
+  /// the parts of a problem that do not change from level to level, a
+  /// literal id is the atom number of the problem shifted left with the
+  /// negation in the low bit, no-ops follow the actions in action indices
+  struct Compiled_Problem
+  {
+    /// returned for propositions whose atom is not in the problem
+    static const unsigned int npos = ~0u;
+
+    /// Constructor
+    Compiled_Problem();
+
+    /// number the atoms of actions, starting propositions and goals and
+    /// compile the actions, under the closed world assumption a negated
+    /// literal is only stored when a precondition or goal needs it,
+    /// interference is kept in directory unless it is empty
+    void compile(const std::set<Action>& actions,
+      const std::set<Proposition>& starting,
+      const std::set<Proposition>& goals, bool closed,
+      const std::string& directory = "");
+
+    /// get literal id of p or npos if its atom is not in the problem
+    unsigned int get_literal(const Proposition& p) const;
+
+    /// get literal ids of the stored literals holding in a starting state,
+    /// under the closed world assumption those of atoms it does not mention
+    /// are negated
+    void get_initial(const std::set<Proposition>& starting,
+      std::vector<unsigned int>& initial) const;
+
+    /// interned atom ids of the problem in increasing order, the atom
+    /// number of each is its position
+    std::vector<unsigned int> atoms;
+
+    /// proposition of each literal id
+    std::vector<Proposition> literals;
+
+    /// number of literal ids, twice the number of atoms in the problem
+    unsigned int literal_count;
+
+    /// whether negated effects are deletes rather than stored literals
+    bool closed_world;
+
+    /// literal ids that get nodes in the graph
+    Bitset stored;
+
+    /// immutable actions shared by every node in the graph, no-ops are
+    /// implicit and never stored
+    std::vector<Action> action_table;
+
+    /// number of actions in action_table
+    unsigned int action_count;
+
+    /// literal ids of preconditions of each action by action id
+    Edge_Table<unsigned int> action_precondition_ids;
+
+    /// action ids with each literal id as a precondition
+    Edge_Table<unsigned int> literal_consumers;
+
+    /// action ids with each stored literal id as an effect
+    Edge_Table<unsigned int> literal_producers;
+
+    /// stored literal ids of effects of each action by action id
+    Edge_Table<unsigned int> action_effect_ids;
+
+    /// stored literal ids made false by each action by action id
+    Edge_Table<unsigned int> action_delete_ids;
+
+    /// pairs of actions and no-ops, by action index, that are mutex in every
+    /// level because one deletes what the other needs or adds
+    Mutex_Matrix interference;
+  };
+} // namespace graphplan
+
+#endif // _GRAPHPLAN_COMPILED_PROBLEM_H_
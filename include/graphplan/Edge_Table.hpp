@@ -0,0 +1,236 @@
+/**
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2014 Anton Dukeman
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * @file Edge_Table.hpp
+ * @author Anton Dukeman <anton.dukeman@gmail.com>
+ *
+ * Compressed sparse row storage of the edges leaving each node id
+ */
+
+#ifndef _GRAPHPLAN_EDGE_TABLE_H_
+#define _GRAPHPLAN_EDGE_TABLE_H_
+
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include <functional>
+#include <cstddef>
+
+namespace graphplan
+{
+  template <typename T>
+  class Edge_Table
+  {
+  public:
+    /// contiguous run of targets of one source
+    class Range
+    {
+    public:
+      /// Constructor
+      Range(const T* b, const T* e) : begin_(b), end_(e) {}
+
+      /// get first target
+      const T* begin() const { return begin_; }
+
+      /// get one past last target
+      const T* end() const { return end_; }
+
+      /// get number of targets
+      std::size_t size() const { return end_ - begin_; }
+
+      /// check for no targets
+      bool empty() const { return begin_ == end_; }
+
+    protected:
+      const T* begin_;
+      const T* end_;
+    }; // class Range
+
+    /// add an edge, collected until build
+    void add(unsigned int source, const T& target);
+
+    /// build rows for sources 0 to n - 1 from the added edges and those of
+    /// any earlier build, each row is sorted like the std::set it replaces
+    void build(unsigned int n);
+
+    /// build the rows build would into next, leaving this table and the
+    /// rows being read from it untouched, the storage of next is reused and
+    /// only rows with new edges are sorted
+    void stage(unsigned int n, Edge_Table& next) const;
+
+    /// exchange edges with t
+    void swap(Edge_Table& t);
+
+    /// get targets of a source, empty if the table is not built
+    Range get(unsigned int source) const;
+
+    /// get number of edges
+    std::size_t size() const;
+
+    /// remove all edges
+    void clear();
+
+  protected:
+    /// replace the rows with pending_ sorted by source
+    void sort_pending(unsigned int n);
+
+    /// edges added since the last build
+    std::vector<std::pair<unsigned int, T> > pending_;
+
+    /// start of each source row in targets_, one extra for the end
+    std::vector<unsigned int> offsets_;
+
+    /// targets of all sources, grouped by source
+    std::vector<T> targets_;
+
+    /// fill position of each row while staging
+    std::vector<unsigned int> cursors_;
+  }; // class Edge_Table
+
+  template <typename T>
+  void
+  Edge_Table<T>::add(unsigned int source, const T& target)
+  {
+    pending_.push_back(std::make_pair(source, target));
+  }
+
+  template <typename T>
+  void
+  Edge_Table<T>::build(unsigned int n)
+  {
+    // keep the edges of the last build
+    for(unsigned int i = 0; i + 1 < offsets_.size(); ++i)
+      for(unsigned int k = offsets_[i]; k < offsets_[i + 1]; ++k)
+        pending_.push_back(std::make_pair(i, targets_[k]));
+    sort_pending(n);
+  }
+
+  template <typename T>
+  void
+  Edge_Table<T>::stage(unsigned int n, Edge_Table& next) const
+  {
+    // each row keeps its sorted targets and gets its new ones after them
+    unsigned int rows = offsets_.empty() ? 0 : offsets_.size() - 1;
+    next.pending_.clear();
+    next.offsets_.assign(n + 1, 0);
+    for(unsigned int i = 0; i < rows; ++i)
+      next.offsets_[i + 1] = offsets_[i + 1] - offsets_[i];
+    for(const std::pair<unsigned int, T>& edge : pending_)
+      ++next.offsets_[edge.first + 1];
+    for(unsigned int i = 0; i < n; ++i)
+      next.offsets_[i + 1] += next.offsets_[i];
+
+    next.targets_.resize(next.offsets_[n]);
+    next.cursors_.resize(n);
+    for(unsigned int i = 0; i < n; ++i)
+    {
+      next.cursors_[i] = next.offsets_[i];
+      if(i < rows)
+      {
+        next.cursors_[i] = std::copy(targets_.begin() + offsets_[i],
+          targets_.begin() + offsets_[i + 1],
+          next.targets_.begin() + next.offsets_[i]) - next.targets_.begin();
+      }
+    }
+    for(const std::pair<unsigned int, T>& edge : pending_)
+      next.targets_[next.cursors_[edge.first]++] = edge.second;
+
+    // only rows with new targets need merging
+    for(unsigned int i = 0; i < n; ++i)
+    {
+      unsigned int kept = i < rows ? offsets_[i + 1] - offsets_[i] : 0;
+      if(next.offsets_[i] + kept == next.offsets_[i + 1])
+        continue;
+      typename std::vector<T>::iterator begin = next.targets_.begin() +
+        next.offsets_[i];
+      typename std::vector<T>::iterator end = next.targets_.begin() +
+        next.offsets_[i + 1];
+      std::sort(begin + kept, end, std::less<T>());
+      std::inplace_merge(begin, begin + kept, end, std::less<T>());
+    }
+  }
+
+  template <typename T>
+  void
+  Edge_Table<T>::swap(Edge_Table& t)
+  {
+    pending_.swap(t.pending_);
+    offsets_.swap(t.offsets_);
+    targets_.swap(t.targets_);
+    cursors_.swap(t.cursors_);
+  }
+
+  template <typename T>
+  void
+  Edge_Table<T>::sort_pending(unsigned int n)
+  {
+    // counting sort by source, then sort within each row
+    offsets_.assign(n + 1, 0);
+    for(const std::pair<unsigned int, T>& edge : pending_)
+      ++offsets_[edge.first + 1];
+    for(unsigned int i = 0; i < n; ++i)
+      offsets_[i + 1] += offsets_[i];
+
+    std::vector<unsigned int> next(offsets_.begin(), offsets_.end() - 1);
+    targets_.resize(pending_.size());
+    for(const std::pair<unsigned int, T>& edge : pending_)
+      targets_[next[edge.first]++] = edge.second;
+    for(unsigned int i = 0; i < n; ++i)
+    {
+      std::sort(targets_.begin() + offsets_[i],
+        targets_.begin() + offsets_[i + 1], std::less<T>());
+    }
+
+    std::vector<std::pair<unsigned int, T> >().swap(pending_);
+  }
+
+  template <typename T>
+  typename Edge_Table<T>::Range
+  Edge_Table<T>::get(unsigned int source) const
+  {
+    if(source + 1 >= offsets_.size())
+      return Range(0, 0);
+    return Range(targets_.data() + offsets_[source],
+      targets_.data() + offsets_[source + 1]);
+  }
+
+  template <typename T>
+  std::size_t
+  Edge_Table<T>::size() const
+  {
+    return targets_.size();
+  }
+
+  template <typename T>
+  void
+  Edge_Table<T>::clear()
+  {
+    pending_.clear();
+    offsets_.clear();
+    targets_.clear();
+  }
+} // namespace graphplan
+
+#endif // _GRAPHPLAN_EDGE_TABLE_H_
@@ -0,0 +1,118 @@
+/**
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2014 Anton Dukeman
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * @file Fixed_Bitset.hpp
+ * @author Anton Dukeman <anton.dukeman@gmail.com>
+ *
+ * Read only bitset with a compile time number of words held inline, copied
+ * from a Bitset and walked by Mutex_Matrix::has_mutex
+ */
+
+#ifndef _GRAPHPLAN_FIXED_BITSET_H_
+#define _GRAPHPLAN_FIXED_BITSET_H_
+
+#include <algorithm>
+
+#include "graphplan/Bitset.hpp"
+
+namespace graphplan
+{
+  template <unsigned int W>
+  class Fixed_Bitset
+  {
+  public:
+    /// storage word
+    typedef Bitset::Word Word;
+
+    /// number of bits that fit
+    static const unsigned int CAPACITY = W * Bitset::WORD_BITS;
+
+    /// Constructor
+    Fixed_Bitset();
+
+    /// copy bits of b, which must fit
+    explicit Fixed_Bitset(const Bitset& b);
+
+    /// get first set bit or Bitset::npos
+    unsigned int find_first() const;
+
+    /// get first set bit after i or Bitset::npos
+    unsigned int find_next(unsigned int i) const;
+
+    /// get storage words
+    const Word* data() const { return words_; }
+
+    /// get number of storage words
+    unsigned int word_count() const { return W; }
+
+  protected:
+    /// storage
+    Word words_[W];
+  }; // class Fixed_Bitset
+
+  template <unsigned int W>
+  Fixed_Bitset<W>::Fixed_Bitset()
+  {
+    std::fill(words_, words_ + W, Word(0));
+  }
+
+  template <unsigned int W>
+  Fixed_Bitset<W>::Fixed_Bitset(const Bitset& b)
+  {
+    std::fill(words_, words_ + W, Word(0));
+    std::copy(b.data(), b.data() + std::min(W, b.word_count()), words_);
+  }
+
+  template <unsigned int W>
+  inline unsigned int
+  Fixed_Bitset<W>::find_first() const
+  {
+    for(unsigned int k = 0; k < W; ++k)
+      if(words_[k] != 0)
+        return k * Bitset::WORD_BITS + __builtin_ctzll(words_[k]);
+    return Bitset::npos;
+  }
+
+  template <unsigned int W>
+  inline unsigned int
+  Fixed_Bitset<W>::find_next(unsigned int i) const
+  {
+    ++i;
+    if(i >= CAPACITY)
+      return Bitset::npos;
+
+    unsigned int k = i / Bitset::WORD_BITS;
+    Word w = words_[k] & (~Word(0) << (i % Bitset::WORD_BITS));
+    while(w == 0)
+    {
+      if(++k == W)
+        return Bitset::npos;
+      w = words_[k];
+    }
+    return k * Bitset::WORD_BITS + __builtin_ctzll(w);
+  }
+} // namespace graphplan
+
+#endif // _GRAPHPLAN_FIXED_BITSET_H_
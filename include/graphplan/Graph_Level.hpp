@@ -0,0 +1,113 @@
+/**
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2014 Anton Dukeman
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * @file Graph_Level.hpp
+ * @author Anton Dukeman <anton.dukeman@gmail.com>
+ *
+ * Storage of the planning graph, each node is stored once with the level it
+ * first appears in and a level is a view over the nodes before it
+ */
+
+#ifndef _GRAPHPLAN_GRAPH_LEVEL_H_
+#define _GRAPHPLAN_GRAPH_LEVEL_H_
+
+#include <vector>
+
+#include "graphplan/Bitset.hpp"
+#include "graphplan/Leveled_Mutex.hpp"
+#include "graphplan/Edge_Table.hpp"
+
+namespace graphplan
+{
+  class Proposition_Node;
+  class Action_Node;
+
+  /// proposition layers of every level, indexed by literal id
+  struct Proposition_Levels
+  {
+    /// literal ids present in the last level
+    Bitset layer;
+
+    /// nodes in the order they appeared, level k holds the first sizes[k]
+    std::vector<Proposition_Node*> nodes;
+
+    /// number of nodes in each level
+    std::vector<unsigned int> sizes;
+
+    /// node of each literal id, null until it appears, kept up to date while
+    /// a level is built so lookups are constant time in every level
+    std::vector<Proposition_Node*> index;
+
+    /// mutex pairs of literal ids in each level
+    Leveled_Mutex mutex;
+
+    /// action nodes with literal as an effect, in the level after the action
+    /// and every level after that
+    Edge_Table<Action_Node*> causes;
+  };
+
+  /// action layers of every level, indexed by action table id
+  struct Action_Levels
+  {
+    /// nodes in the order they appeared, level k holds the first sizes[k]
+    std::vector<Action_Node*> nodes;
+
+    /// number of nodes in each level
+    std::vector<unsigned int> sizes;
+
+    /// mutex pairs of action ids in each level, no-ops follow the actions
+    Leveled_Mutex mutex;
+
+    /// precondition nodes
+    Edge_Table<Proposition_Node*> preconditions;
+  };
+
+  /// edge rows and mutexes of a level built while the level before is
+  /// searched, swapped into the levels once the search stops reading them,
+  /// kept with the graph so the swapped out buffers are reused
+  struct Staged_Level
+  {
+    /// rows of Proposition_Levels::causes
+    Edge_Table<Action_Node*> causes;
+
+    /// rows of Action_Levels::preconditions
+    Edge_Table<Proposition_Node*> preconditions;
+
+    /// mutex pairs of the action level
+    Mutex_Matrix action_mutex;
+
+    /// mutex pairs of the proposition level
+    Mutex_Matrix prop_mutex;
+
+    /// mutex candidate triples of the proposition level
+    Bitset triple_mutex;
+
+    /// action indices supporting each literal of the proposition level,
+    /// rows of literals not in it stay empty
+    std::vector<std::vector<unsigned int> > supporters;
+  };
+} // namespace graphplan
+
+#endif // _GRAPHPLAN_GRAPH_LEVEL_H_
@@ -35,18 +35,55 @@
 #include <vector>
 #include <set>
 #include <map>
+#include <memory>
 
 #include "graphplan/Proposition.hpp"
 #include "graphplan/Proposition_Node.hpp"
 #include "graphplan/Action.hpp"
 #include "graphplan/Action_Node.hpp"
 #include "graphplan/Partial_Order_Plan.hpp"
+#include "graphplan/Bitset.hpp"
+#include "graphplan/Mutex_Matrix.hpp"
+#include "graphplan/Graph_Level.hpp"
+#include "graphplan/Node_Arena.hpp"
+#include "graphplan/Edge_Table.hpp"
+#include "graphplan/Layer_Engine.hpp"
+#include "graphplan/Mutex_Groups.hpp"
+#include "graphplan/Planning_Graph.hpp"
+#include "graphplan/Thread_Pool.hpp"
+#include "graphplan/Triple_Mutex.hpp"
+#include "graphplan/Nogood_Trie.hpp"
 
 namespace graphplan
 {
   class Graphplan
   {
   public:
+    /// literal ids read or written by an action
+    typedef Edge_Table<unsigned int>::Range Literals;
+
+    /// action or no-op id chosen to support each proposition of a level
+    typedef std::map<const Proposition_Node*, unsigned int> Supporters;
+
+    /// sorted literal ids of propositions that cannot all hold in a level
+    typedef Nogood_Trie::Nogood Nogood;
+
+    /// outcome of the last plan
+    enum Status
+    {
+      /// a plan reaching the goals was found
+      FOUND,
+
+      /// the graph leveled off and no plan can exist
+      UNSOLVABLE,
+
+      /// no plan within the number of iterations allowed
+      BUDGET_EXHAUSTED
+    };
+
+    /// plan without a bound on the number of levels
+    static const unsigned int NO_LIMIT = ~0u;
+
     /// Constructor
     Graphplan();
 
@@ -59,9 +96,65 @@ namespace graphplan
     /// add goal propositions
     void add_goal(const Proposition& p);
 
+    /// remove all goal propositions, the graph is kept
+    void clear_goals();
+
     /// add possible action
     void add_action(const Action& a);
 
+    /// remove an action, a compiled graph is kept and the search skips it
+    void remove_action(const Action& a);
+
+    /// get a copy sharing the compiled problem and every level expanded so
+    /// far, goals and removed actions are its own and changing the starting
+    /// state, actions or world mode makes it build a graph of its own, forks
+    /// may plan from different threads but those sharing a graph take turns
+    Graphplan fork() const;
+
+    /// treat atoms not in the starting state as false and negated effects as
+    /// deletes, negated literals are then only stored when a precondition or
+    /// goal needs them
+    void set_closed_world(bool closed = true);
+
+    /// check if negated effects are deletes
+    bool is_closed_world() const;
+
+    /// expand levels with threads threads, plans are the same for any number
+    void set_threads(unsigned int threads);
+
+    /// get number of threads expanding levels
+    unsigned int get_threads() const;
+
+    /// build the next level on a background thread while a level is
+    /// searched, plans are the same either way
+    void set_pipelined(bool pipelined = true);
+
+    /// check if the next level is built while a level is searched
+    bool is_pipelined() const;
+
+    /// also find triples of literals that cannot hold together although no
+    /// two are mutex, for triples read by one action or needed as goals,
+    /// levels take longer to build and the search tries fewer goal sets
+    void set_triple_mutexes(bool triples = true);
+
+    /// check if triple mutexes are found
+    bool has_triple_mutexes() const;
+
+    /// work out which goals are to blame for a failed goal set, remember
+    /// only those as the nogood and skip the other causes of a goal that is
+    /// not to blame, the search tries fewer goal sets but each try costs more
+    void set_backjumping(bool backjumping = true);
+
+    /// check if failures are explained and backjumped over
+    bool has_backjumping() const;
+
+    /// keep nodes and mutex matrices in memory mapped files in directory so
+    /// the kernel can page them out, empty keeps them on the heap
+    void set_scratch_directory(const std::string& directory);
+
+    /// get directory of memory mapped files, empty if on the heap
+    const std::string& get_scratch_directory() const;
+
     /// get starting propositions
     const std::set<Proposition>& get_starting() const;
 
@@ -71,49 +164,195 @@ namespace graphplan
     /// get goals
     const std::set<Proposition>& get_goals() const;
 
-    /// find plan
-    unsigned int plan(unsigned int iterations = 5,
+    /// find plan, reusing levels already expanded by this graph or its
+    /// forks, returns the number of levels searched and stops early once
+    /// the graph has leveled off and no plan can exist
+    unsigned int plan(unsigned int iterations = NO_LIMIT,
       Partial_Order_Plan* plan = 0);
 
+    /// get outcome of the last plan
+    Status get_status() const;
+
+    /// get first level identical to every level after it, Bitset::npos if
+    /// the graph has not leveled off yet
+    unsigned int get_leveled_off() const;
+
+    /// get number of goal sets known to fail in level
+    std::size_t get_nogood_count(unsigned int level) const;
+
+    /// bound the bytes of goal sets known to fail, the least recently used
+    /// are forgotten to stay under it
+    void set_nogood_limit(std::size_t bytes);
+
+    /// get bound on the bytes of goal sets known to fail
+    std::size_t get_nogood_limit() const;
+
+    /// get approximate bytes of goal sets known to fail
+    std::size_t get_nogood_memory() const;
+
+    /// get number of triples that may be found mutex, 0 unless triple
+    /// mutexes are on
+    unsigned int get_triple_count() const;
+
+    /// get number of triples mutex in level
+    std::size_t get_triple_mutex_count(unsigned int level) const;
+
+    /// get number of goal sets the last plan rejected for a mutex triple
+    std::size_t get_triple_prune_count() const;
+
+    /// get number of times the last plan skipped the other causes of a
+    /// goal because its cause was not to blame for a failure
+    std::size_t get_backjump_count() const;
+
     /// get string representation
     std::string to_string() const;
 
-    /// check for goal state
+    /// get allocator holding the nodes of the last graph built
+    const Node_Arena& get_arena() const;
+
+    /// get layer tests chosen for the last plan
+    const Layer_Engine* get_layer_engine() const;
+
+    /// get state invariants found for the last plan, the pairs of each
+    /// group are mutex in every level
+    const Mutex_Groups& get_mutex_groups() const;
+
+    /// check for goal state in the last level, goals mutex there are
+    /// rejected, actions receives the supporters chosen in each level
     bool goal_check(const std::set<Proposition_Node*>& props,
-      std::map<const Proposition_Node*, Action_Node*>& actions) const;
+      std::vector<Supporters>& actions) const;
+
+    /// check for goal state with literal ids of mutex propositions in mutex
+    bool goal_check(const std::set<Proposition_Node*>& props,
+      const Mutex_Matrix& mutex, std::vector<Supporters>& actions) const;
 
   protected:
-    /// perform an action step
-    void iteration(const std::set<Proposition_Node*>& props, 
-      std::set<Proposition_Node*>& new_props, 
-      std::set<Action_Node*>& new_actions);
+    /// build shared action table from actions and starting propositions
+    void compile_actions();
+
+    /// check if every goal is in a level and no two are mutex there
+    bool has_goals(unsigned int level) const;
+
+    /// index of an action or no-op id in the action mutex matrices
+    unsigned int action_index(unsigned int id) const;
+
+    /// remove the levels of the last plan
+    void clear_graph();
+
+    /// search for supporters of the goals in a level that has all of them,
+    /// index holds the node of each literal id
+    bool goal_check(const std::vector<Proposition_Node*>& index,
+      unsigned int level, std::vector<Supporters>& actions) const;
+
+    /// perform an action step from the last level
+    void iteration(unsigned int level);
+
+    /// add the nodes of the level after level and build its edge rows and
+    /// mutexes into next, the search of level may run at the same time
+    void expand(unsigned int level, Staged_Level& next);
+
+    /// make the level built by expand the last level
+    void publish(unsigned int level, Staged_Level& next);
+
+    /// move actions with three preconditions mutex in level back to the
+    /// triggered actions
+    void hold_triple_mutex(unsigned int level,
+      std::vector<unsigned int>& applicable);
+
+    /// move triggered actions with no two preconditions mutex to applicable
+    void find_applicable(const Mutex_Matrix& mutex,
+      std::vector<unsigned int>& applicable);
+
+    /// mark i and j as mutex, with atomic writes if threads share mutex
+    static void set_mutex(Mutex_Matrix& mutex, unsigned int i, unsigned int j,
+      unsigned int threads);
+
+    /// add a node for a literal id first reached in level, actions left with
+    /// no unreached precondition are triggered
+    Proposition_Node* add_proposition_node(unsigned int p, unsigned int level);
 
     /// connect precondition nodes
     void connect_preconditions(const std::set<Proposition_Node*>& found_precond,
       Action_Node* an);
 
     /// connect effect nodes, create if necessary
-    void connect_effect_nodes(const Action& action, 
-      std::set<Proposition_Node*>& new_props, Action_Node* an);
+    void connect_effect_nodes(Action_Node* an);
 
-    /// make mutex connections for actions
-    void make_action_mutex_connections(std::set<Action_Node*>& new_actions,
-      Action_Node* an);
+    /// make mutex connections between the actions of level, only pairs
+    /// mutex in the level before or with a new member are checked
+    void make_action_mutex_connections(unsigned int level,
+      const Mutex_Matrix& prop_mutex, Mutex_Matrix& action_mutex) const;
+
+    /// gather the action indices that could have created each literal id in
+    /// the level after level
+    void find_supporters(unsigned int level,
+      const Edge_Table<Action_Node*>& causes,
+      std::vector<std::vector<unsigned int> >& supporters) const;
+
+    /// make mutex connections between propositions after the action level,
+    /// only pairs mutex in the level before or with a new member are checked
+    void make_proposition_mutex_connections(unsigned int level,
+      const std::vector<std::vector<unsigned int> >& supporters,
+      const Mutex_Matrix& action_mutex, Mutex_Matrix& prop_mutex) const;
+
+    /// mark candidate triples after the action level whose literals cannot
+    /// hold together though no two are mutex in prop_mutex
+    void make_triple_mutex_connections(unsigned int level,
+      const std::vector<std::vector<unsigned int> >& supporters,
+      const Mutex_Matrix& action_mutex, const Mutex_Matrix& prop_mutex,
+      Bitset& triple_mutex) const;
 
-    /// make mutex connections for propositions
-    void make_proposition_mutex_connections(std::set<Proposition_Node*>& new_props);
+    /// check if a triple of literal ids is mutex given the action mutex
+    /// indices that could have created each and the triples mutex in level
+    bool is_mutex(const Triple_Mutex::Triple& triple,
+      const std::vector<std::vector<unsigned int> >& supporters,
+      const Mutex_Matrix& action_mutex, unsigned int level) const;
 
-    /// check for no mutex in set
-    static bool is_mutex(const std::set<Proposition_Node*> props);
+    /// check if two literal ids are mutex given the action mutex indices
+    /// that could have created each, the first as a set, pairs of one
+    /// mutex group are left to the caller
+    bool is_mutex(unsigned int my_id, const Bitset& my_supporters,
+      unsigned int other_id, const std::vector<unsigned int>& other_supporters,
+      const Mutex_Matrix& action_mutex) const;
 
-    /// check if level is good
-    static bool level_goal_check(const std::set<Proposition_Node*>& props,
-      std::map<const Proposition_Node*, Action_Node*>& prop_causes);
+    /// check for mutex in set
+    static bool is_mutex(const Bitset& props, const Mutex_Matrix& mutex);
 
-    /// recursively select cause for effects
-    static bool sub_level_goal_check(const std::set<Proposition_Node*>& props,
-      std::set<Proposition_Node*>::const_iterator cur,
-      std::map<const Proposition_Node*, Action_Node*>& prop_causes);
+    /// check if two actions, by action mutex index, are mutex given the
+    /// literals each reads, the preconditions of the real actions as sets
+    /// and the static interference between them
+    static bool is_mutex(unsigned int my_index, unsigned int other_index,
+      const std::vector<Literals>& reads,
+      const std::vector<Bitset>& preconditions,
+      const Mutex_Matrix& interference, const Mutex_Matrix& prop_mutex);
+
+    /// check if props holds a goal set known to fail in level, key
+    /// receives the literal ids of props and found the failed goal set
+    bool is_nogood(const std::set<Proposition_Node*>& props,
+      unsigned int level, Nogood& key, Nogood& found) const;
+
+    /// check if level is good, on failure conflict receives the literal ids
+    /// of the props that cannot hold together
+    bool level_goal_check(const std::set<Proposition_Node*>& props,
+      unsigned int level, std::vector<Supporters>& prop_causes,
+      Nogood& conflict) const;
+
+    /// recursively select cause for effects, ids of chosen actions in
+    /// selected, on failure conflict receives the literal ids of the props
+    /// to blame given the causes chosen before cur
+    bool sub_level_goal_check(const std::set<Proposition_Node*>& props,
+      unsigned int level, std::set<Proposition_Node*>::const_iterator cur,
+      Bitset& selected, std::vector<Supporters>& prop_causes,
+      Nogood& conflict) const;
+
+    /// try action or no-op id as the cause of cur, undoing it on failure
+    bool select_supporter(const std::set<Proposition_Node*>& props,
+      unsigned int level, std::set<Proposition_Node*>::const_iterator cur,
+      unsigned int id, Bitset& selected,
+      std::vector<Supporters>& prop_causes, Nogood& conflict) const;
+
+    /// check if action or no-op id reads any of sorted literal ids
+    bool needs_any(unsigned int id, const Nogood& literals) const;
 
     /// starting propositions
     std::set<Proposition> starting_;
@@ -121,14 +360,51 @@ namespace graphplan
     /// goal propositions
     std::set<Proposition> goals_;
 
+    /// literal ids of goal propositions
+    Bitset goal_mask_;
+
     /// available actions
     std::set<Action> actions_;
 
-    /// prop nodes in graph
-    std::set<Proposition_Node*> prop_nodes_;
+    /// whether negated effects are deletes rather than stored literals
+    bool closed_world_;
+
+    /// directory of memory mapped files for the graph, empty for the heap
+    std::string scratch_directory_;
+
+    /// action ids removed since the graph was compiled, skipped by the search
+    Bitset disabled_;
+
+    /// whether the next level is built while a level is searched
+    bool pipelined_;
+
+    /// whether triple mutexes are found
+    bool triple_mutexes_;
+
+    /// whether failures are explained and backjumped over
+    bool backjumping_;
+
+    /// whether graph_ is up to date with the actions and starting state
+    bool compiled_;
+
+    /// compiled problem and expanded levels, shared with forks
+    std::shared_ptr<Planning_Graph> graph_;
+
+    /// threads expanding levels, shared with forks
+    std::shared_ptr<Thread_Pool> pool_;
+
+    /// outcome of the last plan
+    Status status_;
+
+    /// goal sets that failed in each level, kept between plans while the
+    /// graph and removed actions stay the same
+    mutable Nogood_Trie nogoods_;
+
+    /// goal sets the last plan rejected for a mutex triple
+    mutable std::size_t triple_prunes_;
 
-    /// action nodes in graph
-    std::set<Action_Node*> act_nodes_;
+    /// causes the last plan skipped by backjumping
+    mutable std::size_t backjumps_;
   }; // class Graphplan
 } // namespace graphplan
 
@@ -0,0 +1,130 @@
+/**
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2014 Anton Dukeman
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * @file Layer_Engine.hpp
+ * @author Anton Dukeman <anton.dukeman@gmail.com>
+ *
+ * Applicability and goal tests on proposition layers, specialized on the
+ * bitset used to hold a layer
+ */
+
+#ifndef _GRAPHPLAN_LAYER_ENGINE_H_
+#define _GRAPHPLAN_LAYER_ENGINE_H_
+
+#include <vector>
+
+#include "graphplan/Bitset.hpp"
+#include "graphplan/Fixed_Bitset.hpp"
+#include "graphplan/Mutex_Matrix.hpp"
+
+namespace graphplan
+{
+  /// applicability and goal tests, preconditions are held in the narrowest
+  /// Fixed_Bitset that fits the literal ids of the problem and the loops are
+  /// instantiated for it, so only the choice of loop is made at run time;
+  /// layers, the goal mask and the mutex matrices stay Bitset and
+  /// Mutex_Matrix since each is touched once per level, not once per action
+  class Layer_Engine
+  {
+  public:
+    /// Constructor, empty engine
+    Layer_Engine();
+
+    /// Constructor, with literal ids of preconditions of each action, all
+    /// below literal_count
+    Layer_Engine(const std::vector<Bitset>& preconditions,
+      unsigned int literal_count);
+
+    /// move ids of actions in triggered, whose preconditions are all in the
+    /// layer, to applicable if no two preconditions are mutex
+    void find_applicable(std::vector<unsigned int>& triggered,
+      const Mutex_Matrix& mutex, std::vector<unsigned int>& applicable) const;
+
+    /// check if every literal id in goals is in layer and no two are mutex
+    bool has_goals(const Bitset& goals, const Bitset& layer,
+      const Mutex_Matrix& mutex) const;
+
+    /// get number of literal ids a layer can hold, 0 if unbounded
+    unsigned int get_capacity() const;
+
+  protected:
+    /// find_applicable on preconditions held in Set
+    template <typename Set>
+    static void find_applicable(const std::vector<Set>& preconditions,
+      std::vector<unsigned int>& triggered, const Mutex_Matrix& mutex,
+      std::vector<unsigned int>& applicable);
+
+    /// copy preconditions into sets of type Set
+    template <typename Set>
+    static void compile(const std::vector<Bitset>& preconditions,
+      std::vector<Set>& sets);
+
+    /// number of literal ids a layer can hold, picks the sets below
+    unsigned int capacity_;
+
+    /// preconditions for up to 64 literal ids
+    std::vector<Fixed_Bitset<1> > narrow_;
+
+    /// preconditions for up to 128 literal ids
+    std::vector<Fixed_Bitset<2> > medium_;
+
+    /// preconditions for up to 256 literal ids
+    std::vector<Fixed_Bitset<4> > broad_;
+
+    /// preconditions for any number of literal ids
+    std::vector<Bitset> wide_;
+  }; // class Layer_Engine
+
+  template <typename Set>
+  void
+  Layer_Engine::find_applicable(const std::vector<Set>& preconditions,
+    std::vector<unsigned int>& triggered, const Mutex_Matrix& mutex,
+    std::vector<unsigned int>& applicable)
+  {
+    // mutex only shrinks, so blocked actions are kept for a later level
+    unsigned int kept = 0;
+    for(unsigned int i : triggered)
+    {
+      if(mutex.has_mutex(preconditions[i]))
+        triggered[kept++] = i;
+      else
+        applicable.push_back(i);
+    }
+    triggered.resize(kept);
+  }
+
+  template <typename Set>
+  void
+  Layer_Engine::compile(const std::vector<Bitset>& preconditions,
+    std::vector<Set>& sets)
+  {
+    sets.clear();
+    sets.reserve(preconditions.size());
+    for(const Bitset& p : preconditions)
+      sets.push_back(Set(p));
+  }
+} // namespace graphplan
+
+#endif // _GRAPHPLAN_LAYER_ENGINE_H_
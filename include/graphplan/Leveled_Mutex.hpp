@@ -0,0 +1,136 @@
+/**
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2014 Anton Dukeman
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * @file Leveled_Mutex.hpp
+ * @author Anton Dukeman <anton.dukeman@gmail.com>
+ *
+ * Mutex pairs of every level, stored as the last level plus the words of
+ * each row that stopped holding at each later level
+ */
+
+#ifndef _GRAPHPLAN_LEVELED_MUTEX_H_
+#define _GRAPHPLAN_LEVELED_MUTEX_H_
+
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <cstddef>
+
+#include "graphplan/Bitset.hpp"
+#include "graphplan/Mutex_Matrix.hpp"
+
+namespace graphplan
+{
+  class Leveled_Mutex
+  {
+  public:
+    /// Constructor
+    Leveled_Mutex(unsigned int n = 0);
+
+    /// resize to n by n, removing all levels, the last level is kept in a
+    /// scratch file in directory if it is not empty
+    void resize(unsigned int n, const std::string& directory = std::string());
+
+    /// get dimension
+    unsigned int size() const;
+
+    /// get number of levels pushed
+    unsigned int get_levels() const;
+
+    /// append the mutex pairs of the next level, mutex is left empty
+    void push_level(Mutex_Matrix& mutex);
+
+    /// get mutex pairs of the last level
+    const Mutex_Matrix& last() const;
+
+    /// check if i and j are mutex in level, both must be in the level
+    bool test(unsigned int i, unsigned int j, unsigned int level) const;
+
+    /// check if i is mutex with any member of s in level
+    bool intersects(unsigned int i, const Bitset& s, unsigned int level) const;
+
+    /// check if any two members of s are mutex in level
+    bool has_mutex(const Bitset& s, unsigned int level) const;
+
+    /// count pairs that have stopped being mutex
+    std::size_t count_ended() const;
+
+  protected:
+    /// bits of one word of a row that stopped being mutex in level
+    struct Ended
+    {
+      /// word of the row
+      unsigned int word;
+
+      /// first level the bits are no longer mutex in
+      unsigned int level;
+
+      /// columns that stopped
+      Mutex_Matrix::Word bits;
+    };
+
+    /// add bits that stopped in word of row i in the level being pushed
+    void end(unsigned int i, unsigned int word, Mutex_Matrix::Word bits);
+
+    /// mutex pairs of the last level
+    Mutex_Matrix last_;
+
+    /// number of levels pushed
+    unsigned int levels_;
+
+    /// words that stopped of each row, with columns on both sides of the
+    /// row and in the order the levels were pushed, mutexes only ever go
+    /// away so a pair holds in every level it is in before its end
+    std::vector<std::vector<Ended> > ended_;
+
+    /// number of pairs that stopped
+    std::size_t ended_count_;
+  }; // class Leveled_Mutex
+
+  inline bool
+  Leveled_Mutex::test(unsigned int i, unsigned int j, unsigned int level) const
+  {
+    if(level >= levels_)
+      return false;
+    if(last_.test(i, j))
+      return true;
+    if(level + 1 == levels_ || i >= ended_.size())
+      return false;
+
+    // later levels are at the back
+    const std::vector<Ended>& row = ended_[i];
+    for(auto it = row.rbegin(); it != row.rend() && it->level > level; ++it)
+    {
+      if(it->word == j / Bitset::WORD_BITS &&
+        ((it->bits >> (j % Bitset::WORD_BITS)) & 1))
+      {
+        return true;
+      }
+    }
+    return false;
+  }
+} // namespace graphplan
+
+#endif // _GRAPHPLAN_LEVELED_MUTEX_H_
@@ -0,0 +1,111 @@
+/**
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2014 Anton Dukeman
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * @file Mutex_Groups.hpp
+ * @author Anton Dukeman <anton.dukeman@gmail.com>
+ *
+ * State invariants found before planning, groups of literals of which at
+ * most one holds in any reachable state, so their pairs are mutex in every
+ * level
+ */
+
+#ifndef _GRAPHPLAN_MUTEX_GROUPS_H_
+#define _GRAPHPLAN_MUTEX_GROUPS_H_
+
+#include <vector>
+#include <set>
+
+#include "graphplan/Bitset.hpp"
+#include "graphplan/Edge_Table.hpp"
+
+namespace graphplan
+{
+  class Mutex_Groups
+  {
+  public:
+    /// literal ids read or written by an action
+    typedef Edge_Table<unsigned int> Literal_Table;
+
+    /// returned for literals not in any group
+    static const unsigned int npos = ~0u;
+
+    /// Constructor
+    Mutex_Groups();
+
+    /// find groups over literal ids below literal_count given the initial
+    /// literals and the preconditions, effects and deletes of each action,
+    /// every literal that can hold ends up in exactly one group
+    void synthesize(unsigned int literal_count,
+      const std::vector<unsigned int>& initial,
+      const Literal_Table& preconditions, const Literal_Table& effects,
+      const Literal_Table& deletes, unsigned int action_count);
+
+    /// remove all groups
+    void clear();
+
+    /// get number of groups
+    unsigned int size() const;
+
+    /// get literal ids of a group
+    const std::vector<unsigned int>& get_group(unsigned int g) const;
+
+    /// get group of a literal id or npos
+    unsigned int get_group_of(unsigned int literal) const;
+
+    /// check if two different literal ids are in the same group of more than
+    /// one literal, and so never hold together
+    bool same_group(unsigned int a, unsigned int b) const;
+
+    /// get number of literal pairs known mutex through the groups
+    unsigned int count_pairs() const;
+
+  protected:
+    /// get representative of the component of p, halving paths
+    static unsigned int find(std::vector<unsigned int>& component,
+      unsigned int p);
+
+    /// check if a and b are still candidates for never holding together
+    bool is_candidate(unsigned int a, unsigned int b) const;
+
+    /// literal ids of each group
+    std::vector<std::vector<unsigned int> > groups_;
+
+    /// group of each literal id
+    std::vector<unsigned int> group_of_;
+
+    /// literals each literal may never hold together with, shrinks while
+    /// synthesizing until no action can make both hold
+    std::vector<std::set<unsigned int> > partners_;
+  }; // class Mutex_Groups
+
+  inline bool
+  Mutex_Groups::same_group(unsigned int a, unsigned int b) const
+  {
+    return a != b && a < group_of_.size() && b < group_of_.size() &&
+      group_of_[a] != npos && group_of_[a] == group_of_[b];
+  }
+} // namespace graphplan
+
+#endif // _GRAPHPLAN_MUTEX_GROUPS_H_
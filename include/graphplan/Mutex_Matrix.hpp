@@ -0,0 +1,146 @@
+/**
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2014 Anton Dukeman
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * @file Mutex_Matrix.hpp
+ * @author Anton Dukeman <anton.dukeman@gmail.com>
+ *
+ * Packed lower triangular bit matrix of mutex pairs for one level
+ */
+
+#ifndef _GRAPHPLAN_MUTEX_MATRIX_H_
+#define _GRAPHPLAN_MUTEX_MATRIX_H_
+
+#include <vector>
+#include <string>
+#include <cstddef>
+#include <algorithm>
+
+#include "graphplan/Bitset.hpp"
+#include "graphplan/Scratch_Buffer.hpp"
+#include "graphplan/Bit_Kernels.hpp"
+
+namespace graphplan
+{
+  class Mutex_Matrix
+  {
+  public:
+    /// storage word
+    typedef Bitset::Word Word;
+
+    /// Constructor, words are kept in a scratch file in directory if it is
+    /// not empty
+    Mutex_Matrix(unsigned int n = 0,
+      const std::string& directory = std::string());
+
+    /// resize to n by n, clearing all pairs
+    void resize(unsigned int n);
+
+    /// get dimension
+    unsigned int size() const;
+
+    /// mark i and j as mutex
+    void set(unsigned int i, unsigned int j);
+
+    /// mark i and j as mutex, safe while other threads set other pairs
+    void set_shared(unsigned int i, unsigned int j);
+
+    /// check if i and j are mutex
+    bool test(unsigned int i, unsigned int j) const;
+
+    /// check if i is mutex with any member of s
+    bool intersects(unsigned int i, const Bitset& s) const;
+
+    /// check if i is mutex with every member of s
+    bool covers(unsigned int i, const Bitset& s) const;
+
+    /// get first j below i that is mutex with i or Bitset::npos, each pair
+    /// is found from its larger member
+    unsigned int find_first(unsigned int i) const;
+
+    /// get first j after k and below i that is mutex with i or Bitset::npos
+    unsigned int find_next(unsigned int i, unsigned int k) const;
+
+    /// check if any two members of s are mutex, s is a Bitset or a
+    /// Fixed_Bitset
+    template <typename Set>
+    bool has_mutex(const Set& s) const;
+
+    /// count mutex pairs
+    std::size_t count() const;
+
+    /// get first word of row i, which holds the bits for columns below i in
+    /// (i + Bitset::WORD_BITS - 1) / Bitset::WORD_BITS words
+    const Word* row(unsigned int i) const;
+
+  protected:
+
+    /// dimension
+    unsigned int size_;
+
+    /// word offset of each row, rows start on a word boundary
+    std::vector<std::size_t> offsets_;
+
+    /// scratch directory for the words, empty for the heap
+    std::string directory_;
+
+    /// storage
+    Scratch_Buffer storage_;
+
+    /// words of storage_
+    Word* words_;
+  }; // class Mutex_Matrix
+
+  inline bool
+  Mutex_Matrix::test(unsigned int i, unsigned int j) const
+  {
+    if(i < j)
+      return test(j, i);
+    if(i == j || i >= size_)
+      return false;
+    return (words_[offsets_[i] + j / Bitset::WORD_BITS] >>
+      (j % Bitset::WORD_BITS)) & 1;
+  }
+
+  template <typename Set>
+  bool
+  Mutex_Matrix::has_mutex(const Set& s) const
+  {
+    // every pair is seen from the row of its larger member
+    const Word* w = s.data();
+    for(unsigned int i = s.find_first(); i != Bitset::npos && i < size_;
+      i = s.find_next(i))
+    {
+      const Word* r = row(i);
+      unsigned int words = std::min<std::size_t>(offsets_[i + 1] - offsets_[i],
+        s.word_count());
+      if(words_intersect(r, w, words))
+        return true;
+    }
+
+    return false;
+  }
+} // namespace graphplan
+
+#endif // _GRAPHPLAN_MUTEX_MATRIX_H_
@@ -0,0 +1,127 @@
+/**
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2014 Anton Dukeman
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * @file Node_Arena.hpp
+ * @author Anton Dukeman <anton.dukeman@gmail.com>
+ *
+ * Bump allocator owning the nodes of a planning graph
+ */
+
+#ifndef _GRAPHPLAN_NODE_ARENA_H_
+#define _GRAPHPLAN_NODE_ARENA_H_
+
+#include <vector>
+#include <string>
+#include <utility>
+#include <new>
+#include <cstddef>
+#include <type_traits>
+
+#include "graphplan/Scratch_Buffer.hpp"
+
+namespace graphplan
+{
+  class Node_Arena
+  {
+  public:
+    /// Constructor
+    Node_Arena(std::size_t block_size = 64 * 1024);
+
+    /// get aligned uninitialized memory, valid until reset
+    void* allocate(std::size_t size, std::size_t align);
+
+    /// construct an object in the arena, it is never destroyed
+    template <typename T, typename... Args>
+    T* create(Args&&... args);
+
+    /// release everything allocated, keeping the blocks for reuse unless
+    /// the directory changed while they were in use
+    void reset();
+
+    /// keep blocks in scratch files in directory, or on the heap if it is
+    /// empty, free blocks of another backing are dropped now and blocks in
+    /// use at the next reset
+    void set_scratch_directory(const std::string& directory);
+
+    /// get directory of scratch files, empty for the heap
+    const std::string& get_scratch_directory() const;
+
+    /// get bytes handed out since the last reset
+    std::size_t get_used() const;
+
+    /// get bytes held in blocks
+    std::size_t get_capacity() const;
+
+    /// get most bytes ever in use at once
+    std::size_t get_high_water_mark() const;
+
+    /// not copyable, nodes point at each other
+    Node_Arena(const Node_Arena&) = delete;
+    Node_Arena& operator=(const Node_Arena&) = delete;
+
+  protected:
+    /// smallest block kept in a scratch file, each is one mapping
+    static const std::size_t MAPPED_BLOCK_SIZE = 16 * 1024 * 1024;
+
+    /// memory block
+    typedef Scratch_Buffer Block;
+
+    /// all blocks, those past current_ are free
+    std::vector<Block> blocks_;
+
+    /// default size of a new block
+    std::size_t block_size_;
+
+    /// directory of scratch files for new blocks, empty for the heap
+    std::string directory_;
+
+    /// block being allocated from
+    std::size_t current_;
+
+    /// next free byte in the current block
+    std::size_t offset_;
+
+    /// bytes handed out since the last reset
+    std::size_t used_;
+
+    /// most bytes ever handed out between resets
+    std::size_t high_water_;
+
+    /// whether blocks in use are backed for an earlier directory
+    bool stale_;
+  }; // class Node_Arena
+
+  template <typename T, typename... Args>
+  T*
+  Node_Arena::create(Args&&... args)
+  {
+    static_assert(std::is_trivially_destructible<T>::value,
+      "arena objects are released without running destructors");
+    void* p = allocate(sizeof(T), alignof(T));
+    return new (p) T(std::forward<Args>(args)...);
+  }
+} // namespace graphplan
+
+#endif // _GRAPHPLAN_NODE_ARENA_H_
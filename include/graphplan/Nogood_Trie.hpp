@@ -0,0 +1,175 @@
+/**
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2014 Anton Dukeman
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * @file Nogood_Trie.hpp
+ * @author Anton Dukeman <anton.dukeman@gmail.com>
+ *
+ * Goal sets known to fail in each level, kept in a set-trie so a goal set
+ * holding any of them is found without searching it
+ */
+
+#ifndef _GRAPHPLAN_NOGOOD_TRIE_H_
+#define _GRAPHPLAN_NOGOOD_TRIE_H_
+
+#include <vector>
+#include <cstddef>
+
+namespace graphplan
+{
+  class Nogood_Trie
+  {
+  public:
+    /// sorted literal ids of propositions that cannot all hold in a level
+    typedef std::vector<unsigned int> Nogood;
+
+    /// no bound on the memory held
+    static const std::size_t NO_LIMIT = ~std::size_t(0);
+
+    /// Constructor
+    Nogood_Trie(std::size_t limit = NO_LIMIT);
+
+    /// bound the bytes held, the least recently used nogoods are dropped
+    /// once an insert goes over until a quarter of the bound is free
+    void set_limit(std::size_t bytes);
+
+    /// get bound on the bytes held
+    std::size_t get_limit() const;
+
+    /// never drop the nogoods of level, so its insert count only grows when
+    /// a nogood it never held is added, the bound may then be exceeded
+    void keep_level(unsigned int level);
+
+    /// check if a nogood of level is a subset of sorted literal ids, the
+    /// nogood found counts as used
+    bool contains_subset(unsigned int level, const Nogood& goals);
+
+    /// get a nogood of level that is a subset of sorted literal ids into
+    /// found, returns false if there is none
+    bool get_subset(unsigned int level, const Nogood& goals, Nogood& found);
+
+    /// add sorted literal ids as a nogood of level, dropping the nogoods
+    /// of level it is a subset of
+    void insert(unsigned int level, const Nogood& goals);
+
+    /// get number of nogoods of level
+    std::size_t size(unsigned int level) const;
+
+    /// get number of inserts into level, which only ever grows
+    std::size_t get_insert_count(unsigned int level) const;
+
+    /// get number of nogoods dropped to stay under the bound
+    std::size_t get_evict_count() const;
+
+    /// get approximate bytes held by the nodes in use and the levels, free
+    /// nodes waiting for reuse and spare vector capacity are not counted
+    std::size_t get_memory() const;
+
+    /// remove all nogoods and forget the kept level and evictions, the
+    /// bound is kept
+    void clear();
+
+  protected:
+    /// no node
+    static const unsigned int NONE = ~0u;
+
+    /// one literal id of the nogoods sharing a prefix
+    struct Node
+    {
+      /// literal id, the level for the root of a level
+      unsigned int literal;
+
+      /// parent node, NONE for the root of a level
+      unsigned int parent;
+
+      /// first child, children are in increasing literal id order
+      unsigned int child;
+
+      /// next child of parent
+      unsigned int sibling;
+
+      /// clock of the last use if a nogood ends here, 0 otherwise
+      std::size_t used;
+    };
+
+    /// get a cleared node from the free list or the end of nodes_
+    unsigned int allocate(unsigned int literal, unsigned int parent);
+
+    /// get child of node with literal id, created if missing
+    unsigned int find_child(unsigned int node, unsigned int literal);
+
+    /// get node of a nogood under node that is a subset of goals from i on
+    unsigned int find_subset(unsigned int node, const Nogood& goals,
+      unsigned int i) const;
+
+    /// gather nodes of nogoods under node that hold goals from i on
+    void find_supersets(unsigned int node, const Nogood& goals,
+      unsigned int i, std::vector<unsigned int>& found) const;
+
+    /// remove the nogood ending at node and the nodes no longer needed
+    void erase(unsigned int node);
+
+    /// get level of the nogood ending at node
+    unsigned int level_of(unsigned int node) const;
+
+    /// drop the least recently used nogoods, except those of the kept
+    /// level, until a quarter of the bound is free, then set when to drop
+    /// again
+    void evict();
+
+    /// bound on the bytes held
+    std::size_t limit_;
+
+    /// bytes held that make an insert drop nogoods, the bound unless the
+    /// kept level alone holds more, then a quarter more than was left so
+    /// each pass over the nodes pays for many inserts
+    std::size_t high_water_;
+
+    /// level whose nogoods are never dropped, NONE for none
+    unsigned int kept_;
+
+    /// all nodes, free ones included
+    std::vector<Node> nodes_;
+
+    /// nodes free for reuse
+    std::vector<unsigned int> free_;
+
+    /// root of each level, NONE until a nogood is added
+    std::vector<unsigned int> roots_;
+
+    /// number of nogoods of each level
+    std::vector<std::size_t> counts_;
+
+    /// number of inserts into each level
+    std::vector<std::size_t> inserts_;
+
+    /// ticks on every insert and use
+    std::size_t clock_;
+
+    /// number of nogoods dropped
+    std::size_t evicted_;
+  }; // class Nogood_Trie
+} // namespace graphplan
+
+#endif // _GRAPHPLAN_NOGOOD_TRIE_H_
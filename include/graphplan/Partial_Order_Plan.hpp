@@ -45,7 +45,7 @@ namespace graphplan
     /// Constructor
     Partial_Order_Plan();
 
-    /// add action at stage
+    /// add a copy of action at stage, the plan owns its actions
     void add_action(const unsigned int& stage, const Action& a);
 
     /// get actions at all stages
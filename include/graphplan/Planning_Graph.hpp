@@ -0,0 +1,113 @@
+/**
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2014 Anton Dukeman
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * @file Planning_Graph.hpp
+ * @author Anton Dukeman <anton.dukeman@gmail.com>
+ *
+ * Compiled problem and the levels expanded from it, shared by forks of a
+ * Graphplan
+ */
+
+#ifndef _GRAPHPLAN_PLANNING_GRAPH_H_
+#define _GRAPHPLAN_PLANNING_GRAPH_H_
+
+#include <vector>
+#include <mutex>
+
+#include "graphplan/Proposition.hpp"
+#include "graphplan/Compiled_Problem.hpp"
+#include "graphplan/Bitset.hpp"
+#include "graphplan/Mutex_Matrix.hpp"
+#include "graphplan/Edge_Table.hpp"
+#include "graphplan/Graph_Level.hpp"
+#include "graphplan/Node_Arena.hpp"
+#include "graphplan/Layer_Engine.hpp"
+#include "graphplan/Mutex_Groups.hpp"
+#include "graphplan/Triple_Mutex.hpp"
+
+namespace graphplan
+{
+  /// levels are only ever appended, so the nodes and mutex pairs of a level
+  /// once built stay the same for every fork sharing the graph, but planning
+  /// still changes the arena, the staged level and the bookkeeping of the
+  /// last level, so forks plan on it one at a time while holding lock
+  struct Planning_Graph : public Compiled_Problem
+  {
+    /// Constructor
+    Planning_Graph() :
+      leveled_off(Bitset::npos)
+    {
+    }
+
+    /// literal ids of the starting level
+    std::vector<unsigned int> initial;
+
+    /// literal ids of preconditions of each action in action_table
+    std::vector<Bitset> action_preconditions;
+
+    /// literal ids 0 to literal_count - 1, read by the no-ops
+    std::vector<unsigned int> literal_ids;
+
+    /// literal ids read by each action index, the preconditions of an action
+    /// and the literal a no-op carries forward
+    std::vector<Edge_Table<unsigned int>::Range> reads;
+
+    /// groups of literals of which at most one holds in any reachable state
+    Mutex_Groups mutex_groups;
+
+    /// candidate triples of literal ids and those mutex in each level
+    Triple_Mutex triples;
+
+    /// applicability and goal tests specialized on the number of literals
+    Layer_Engine layer_engine;
+
+    /// owns every node in the graph
+    Node_Arena arena;
+
+    /// proposition levels of the graph
+    Proposition_Levels prop_levels;
+
+    /// action levels of the graph
+    Action_Levels action_levels;
+
+    /// the next level while it is built
+    Staged_Level staged;
+
+    /// first level identical to the next, Bitset::npos until one is
+    unsigned int leveled_off;
+
+    /// number of preconditions of each action not yet in the last level
+    std::vector<unsigned int> unreached;
+
+    /// actions with every precondition reached but not yet in the graph,
+    /// waiting for their preconditions to stop being mutex
+    std::vector<unsigned int> triggered;
+
+    /// held by the fork planning on the graph
+    std::mutex lock;
+  };
+} // namespace graphplan
+
+#endif // _GRAPHPLAN_PLANNING_GRAPH_H_
@@ -54,6 +54,12 @@ namespace graphplan
     /// get proposition name
     const std::string& get_name() const;
 
+    /// get literal id, atom id with negation in the low bit
+    unsigned int get_id() const;
+
+    /// get atom id
+    unsigned int get_atom() const;
+
     /// get negated
     bool is_negated() const;
 
@@ -70,11 +76,8 @@ namespace graphplan
     std::string to_string() const;
 
   protected:
-    /// name of the proposition
-    std::string name_;
-
-    /// is negated
-    bool negated_;
+    /// interned name of the proposition shifted left, negation in low bit
+    unsigned int id_;
   }; // class Proposition
 } // namespace graphplan
 
@@ -33,46 +33,36 @@
 #define _GRAPHPLAN_PROPOSITION_NODE_H_
 
 #include <string>
-#include <set>
 
 #include "graphplan/Proposition.hpp"
 
 namespace graphplan
 {
-  class Action_Node;
-
   class Proposition_Node
   {
   public:
-    /// Create instance of proposition
-    Proposition_Node(const Proposition& p);
+    /// Create instance of proposition first appearing at a level, its
+    /// literal id is the id of the proposition
+    Proposition_Node(const Proposition& p, unsigned int level = 0);
+
+    /// Create instance of proposition with literal id in a compiled problem
+    Proposition_Node(const Proposition& p, unsigned int level,
+      unsigned int literal);
 
     /// Copy Constructor
     Proposition_Node(const Proposition_Node& p);
 
-    /// add another supply action node
-    void add_supply(Action_Node* a);
-
-    /// add another cause action node
-    void add_cause(Action_Node* a);
-
-    /// add another mutex node
-    void add_mutex(const Proposition_Node* p);
-
     /// get proposition name
     std::string get_name() const;
 
     /// get proposition
     const Proposition& get_proposition() const;
 
-    /// get action nodes this is a precondition of
-    const std::set<Action_Node*>& get_supply() const;
-
-    /// get action nodes this is an effect of
-    const std::set<Action_Node*>& get_causes() const;
+    /// get first level this node is in
+    unsigned int get_level() const;
 
-    /// get proposition nodes this node is mutex with
-    const std::set<const Proposition_Node*>& get_mutex() const;
+    /// get literal id of the proposition in the graph holding the node
+    unsigned int get_literal() const;
 
     /// determine if this is a proposition
     bool instance_of(const Proposition& p) const;
@@ -84,14 +74,11 @@ namespace graphplan
     /// name of the proposition
     Proposition proposition_;
 
-    /// action nodes this proposition is a precondition of
-    std::set<Action_Node*> supply_;
-
-    /// action nodes this propositions is an effect of
-    std::set<Action_Node*> causes_;
+    /// first level this node is in, it is in every level after
+    unsigned int level_;
 
-    /// mutex propositions
-    std::set<const Proposition_Node*> mutex_;
+    /// literal id in the graph holding the node
+    unsigned int literal_;
   }; // class Proposition_Node
 } // namespace graphplan
 
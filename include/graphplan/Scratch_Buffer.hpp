@@ -0,0 +1,114 @@
+/**
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2014 Anton Dukeman
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * @file Scratch_Buffer.hpp
+ * @author Anton Dukeman <anton.dukeman@gmail.com>
+ *
+ * Zeroed memory held on the heap or in a memory mapped scratch file
+ */
+
+#ifndef _GRAPHPLAN_SCRATCH_BUFFER_H_
+#define _GRAPHPLAN_SCRATCH_BUFFER_H_
+
+#include <string>
+#include <cstddef>
+
+namespace graphplan
+{
+  class Scratch_Buffer
+  {
+  public:
+    /// Constructor, empty
+    Scratch_Buffer();
+
+    /// Constructor, size zeroed bytes on the heap or, if directory is not
+    /// empty, in a file there that is unlinked at once so the kernel can
+    /// page it out instead of running out of memory, throws std::bad_alloc
+    /// if neither works
+    Scratch_Buffer(std::size_t size,
+      const std::string& directory = std::string());
+
+    /// Destructor
+    ~Scratch_Buffer();
+
+    /// move constructor, b is left empty
+    Scratch_Buffer(Scratch_Buffer&& b);
+
+    /// move assignment, b is left empty
+    Scratch_Buffer& operator=(Scratch_Buffer&& b);
+
+    /// not copyable, a mapping has one owner
+    Scratch_Buffer(const Scratch_Buffer&) = delete;
+    Scratch_Buffer& operator=(const Scratch_Buffer&) = delete;
+
+    /// get memory, null if empty
+    char* data();
+
+    /// get memory, null if empty
+    const char* data() const;
+
+    /// get number of bytes
+    std::size_t size() const;
+
+    /// check if the memory is backed by a scratch file
+    bool is_mapped() const;
+
+    /// exchange contents
+    void swap(Scratch_Buffer& b);
+
+  protected:
+    /// release the memory
+    void release();
+
+    /// memory
+    char* data_;
+
+    /// number of bytes
+    std::size_t size_;
+
+    /// memory is a file mapping rather than heap
+    bool mapped_;
+  }; // class Scratch_Buffer
+
+  inline char*
+  Scratch_Buffer::data()
+  {
+    return data_;
+  }
+
+  inline const char*
+  Scratch_Buffer::data() const
+  {
+    return data_;
+  }
+
+  inline std::size_t
+  Scratch_Buffer::size() const
+  {
+    return size_;
+  }
+} // namespace graphplan
+
+#endif // _GRAPHPLAN_SCRATCH_BUFFER_H_
@@ -0,0 +1,109 @@
+/**
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2014 Anton Dukeman
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * @file Thread_Pool.hpp
+ * @author Anton Dukeman <anton.dukeman@gmail.com>
+ *
+ * Fixed set of threads that run numbered tasks and wait for them all
+ */
+
+#ifndef _GRAPHPLAN_THREAD_POOL_H_
+#define _GRAPHPLAN_THREAD_POOL_H_
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+
+namespace graphplan
+{
+  class Thread_Pool
+  {
+  public:
+    /// task run with its number
+    typedef std::function<void(unsigned int)> Task;
+
+    /// Constructor, the thread calling run counts as one of threads
+    Thread_Pool(unsigned int threads = 1);
+
+    /// Destructor, joins the threads
+    ~Thread_Pool();
+
+    /// get number of threads
+    unsigned int size() const;
+
+    /// run task(0) to task(count - 1) across the threads and return once all
+    /// are done, tasks are claimed in order but may finish in any order
+    void run(unsigned int count, const Task& task);
+
+    /// not copyable, threads wait on members
+    Thread_Pool(const Thread_Pool&) = delete;
+    Thread_Pool& operator=(const Thread_Pool&) = delete;
+
+  protected:
+    /// run tasks of each batch until stopped
+    void work();
+
+    /// run tasks of the current batch until none are left
+    void drain();
+
+    /// threads other than the caller of run
+    std::vector<std::thread> workers_;
+
+    /// one batch runs at a time
+    std::mutex run_mutex_;
+
+    /// guards the members below
+    std::mutex mutex_;
+
+    /// signalled when a batch starts or the pool stops
+    std::condition_variable start_;
+
+    /// signalled when a worker finishes a batch
+    std::condition_variable done_;
+
+    /// task of the current batch
+    const Task* task_;
+
+    /// number of tasks in the current batch
+    unsigned int count_;
+
+    /// next task number to claim
+    std::atomic<unsigned int> next_;
+
+    /// workers still running the current batch
+    unsigned int busy_;
+
+    /// number of batches started
+    unsigned long batch_;
+
+    /// whether the threads should exit
+    bool stop_;
+  }; // class Thread_Pool
+} // namespace graphplan
+
+#endif // _GRAPHPLAN_THREAD_POOL_H_
@@ -0,0 +1,118 @@
+/**
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2014 Anton Dukeman
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * @file Triple_Mutex.hpp
+ * @author Anton Dukeman <anton.dukeman@gmail.com>
+ *
+ * Triples of literal ids that cannot hold together in a level although no
+ * two of them are mutex, kept only for candidate triples chosen up front
+ */
+
+#ifndef _GRAPHPLAN_TRIPLE_MUTEX_H_
+#define _GRAPHPLAN_TRIPLE_MUTEX_H_
+
+#include <vector>
+#include <array>
+#include <cstddef>
+
+#include "graphplan/Bitset.hpp"
+
+namespace graphplan
+{
+  class Triple_Mutex
+  {
+  public:
+    /// literal ids of a triple in increasing order
+    typedef std::array<unsigned int, 3> Triple;
+
+    /// returned for triples that are not candidates
+    static const unsigned int npos = ~0u;
+
+    /// Constructor
+    Triple_Mutex();
+
+    /// add every triple of sorted literal ids as a candidate, collected
+    /// until build
+    void add_candidates(const std::vector<unsigned int>& literals);
+
+    /// index the candidates added, removing all levels
+    void build();
+
+    /// remove all candidates and levels
+    void clear();
+
+    /// get number of candidates
+    unsigned int size() const;
+
+    /// get literal ids of candidate t
+    const Triple& get(unsigned int t) const;
+
+    /// get index of the candidate of three different literal ids or npos
+    unsigned int find(unsigned int a, unsigned int b, unsigned int c) const;
+
+    /// get number of levels pushed
+    unsigned int get_levels() const;
+
+    /// remove all levels
+    void clear_levels();
+
+    /// append the mutex candidates of the next level, mutex is left empty
+    void push_level(Bitset& mutex);
+
+    /// get mutex candidates of the last level
+    const Bitset& last() const;
+
+    /// check if candidate t is mutex in level
+    bool test(unsigned int t, unsigned int level) const;
+
+    /// check if any three of sorted literal ids are a mutex candidate in
+    /// level
+    bool has_mutex(const std::vector<unsigned int>& literals,
+      unsigned int level) const;
+
+    /// get a candidate of three of sorted literal ids mutex in level or
+    /// npos
+    unsigned int find_mutex(const std::vector<unsigned int>& literals,
+      unsigned int level) const;
+
+    /// count mutex candidates in level
+    std::size_t count(unsigned int level) const;
+
+  protected:
+    /// sorted candidates
+    std::vector<Triple> triples_;
+
+    /// mutex candidates of each level
+    std::vector<Bitset> levels_;
+  }; // class Triple_Mutex
+
+  inline bool
+  Triple_Mutex::test(unsigned int t, unsigned int level) const
+  {
+    return level < levels_.size() && levels_[level].test(t);
+  }
+} // namespace graphplan
+
+#endif // _GRAPHPLAN_TRIPLE_MUTEX_H_
@@ -84,12 +84,6 @@ graphplan::Action::get_preconditions() const
   return preconditions_;
 }
 
-bool
-graphplan::Action::is_maintenance_action() const
-{
-  return name_.find("maintenance") != std::string::npos;
-}
-
 string
 graphplan::Action::to_string() const
 {
@@ -32,66 +32,41 @@
 #include "graphplan/Action_Node.hpp"
 
 #include <string>
-#include <set>
 
-using std::set;
 using std::string;
 
-graphplan::Action_Node::Action_Node(const Action& a) :
-  action_(a)
+graphplan::Action_Node::Action_Node(const Action& a, unsigned int id,
+  unsigned int level) :
+  action_(&a), id_(id), level_(level)
 {
 }
 
-void
-graphplan::Action_Node::add_precondition(Proposition_Node* p)
-{
-  preconditions_.insert(p);
-}
-
-void
-graphplan::Action_Node::add_effect(Proposition_Node* p)
-{
-  effects_.insert(p);
-}
-
-void
-graphplan::Action_Node::add_mutex(Action_Node* a)
-{
-  mutex_.insert(a);
-}
-
 const graphplan::Action&
 graphplan::Action_Node::get_action() const
 {
-  return action_;
-}
-
-const set<graphplan::Proposition_Node*>&
-graphplan::Action_Node::get_preconditions() const
-{
-  return preconditions_;
+  return *action_;
 }
 
-const set<graphplan::Proposition_Node*>&
-graphplan::Action_Node::get_effects() const
+unsigned int
+graphplan::Action_Node::get_id() const
 {
-  return effects_;
+  return id_;
 }
 
-const set<graphplan::Action_Node*>&
-graphplan::Action_Node::get_mutex() const
+unsigned int
+graphplan::Action_Node::get_level() const
 {
-  return mutex_;
+  return level_;
 }
 
 string
 graphplan::Action_Node::get_name() const
 {
-  return action_.get_name();
+  return action_->get_name();
 }
 
 bool
 graphplan::Action_Node::is_instance_of(const Action& a) const
 {
-  return action_ == a;
+  return *action_ == a;
 }
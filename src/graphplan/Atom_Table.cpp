@@ -0,0 +1,106 @@
+/**
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2014 Anton Dukeman
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * @file Atom_Table.cpp
+ * @author Anton Dukeman <anton.dukeman@gmail.com>
+ *
+ * Symbol table interning proposition names to integer ids, only names are
+ * kept here, a compiled problem numbers its own atoms densely
+ */
+
+#include "graphplan/Atom_Table.hpp"
+
+using std::string;
+using std::mutex;
+using std::lock_guard;
+
+graphplan::Atom_Table&
+graphplan::Atom_Table::instance()
+{
+  static Atom_Table table;
+  return table;
+}
+
+const unsigned int graphplan::Atom_Table::BLOCKS;
+
+graphplan::Atom_Table::Atom_Table() :
+  size_(0)
+{
+  for(unsigned int b = 0; b < BLOCKS; ++b)
+    blocks_[b].store(0, std::memory_order_relaxed);
+}
+
+graphplan::Atom_Table::~Atom_Table()
+{
+  for(unsigned int b = 0; b < BLOCKS; ++b)
+    delete[] blocks_[b].load(std::memory_order_relaxed);
+}
+
+unsigned int
+graphplan::Atom_Table::block_of(unsigned int id, unsigned int& offset)
+{
+  // ids 2^b - 1 up to 2^(b + 1) - 2 share block b
+  unsigned int b = 31 - __builtin_clz(id + 1);
+  offset = id + 1 - (1u << b);
+  return b;
+}
+
+unsigned int
+graphplan::Atom_Table::intern(const string& name)
+{
+  lock_guard<mutex> guard(lock_);
+  auto it = ids_.find(name);
+  if(it != ids_.end())
+    return it->second;
+
+  // the name is in place before the new size is published
+  unsigned int id = size_.load(std::memory_order_relaxed);
+  unsigned int offset;
+  unsigned int b = block_of(id, offset);
+  string* block = blocks_[b].load(std::memory_order_relaxed);
+  if(block == 0)
+  {
+    block = new string[std::size_t(1) << b];
+    blocks_[b].store(block, std::memory_order_release);
+  }
+  block[offset] = name;
+  size_.store(id + 1, std::memory_order_release);
+  ids_[name] = id;
+  return id;
+}
+
+const string&
+graphplan::Atom_Table::get_name(unsigned int id) const
+{
+  unsigned int offset;
+  unsigned int b = block_of(id, offset);
+  return blocks_[b].load(std::memory_order_acquire)[offset];
+}
+
+unsigned int
+graphplan::Atom_Table::size() const
+{
+  return size_.load(std::memory_order_acquire);
+}
@@ -0,0 +1,344 @@
+/**
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2014 Anton Dukeman
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * @file Batch_Graph.cpp
+ * @author Anton Dukeman <anton.dukeman@gmail.com>
+ *
+ * Planning graph of up to 64 problems that share actions and goals but start
+ * in different states, each node and mutex pair holds one bit per problem
+ */
+
+#include "graphplan/Batch_Graph.hpp"
+
+#include "graphplan/Mutex_Groups.hpp"
+
+using std::vector;
+using std::set;
+
+const unsigned int graphplan::Batch_Graph::LANES;
+const unsigned int graphplan::Batch_Graph::npos;
+const unsigned int graphplan::Batch_Graph::NO_LIMIT;
+
+graphplan::Batch_Graph::Batch_Graph() :
+  closed_world_(false), instances_(0)
+{
+}
+
+void
+graphplan::Batch_Graph::add_action(const Action& a)
+{
+  actions_.insert(a);
+}
+
+void
+graphplan::Batch_Graph::add_goal(const Proposition& p)
+{
+  goals_.insert(p);
+}
+
+unsigned int
+graphplan::Batch_Graph::add_instance(const set<Proposition>& starting)
+{
+  if(starting_.size() == LANES)
+    return npos;
+
+  starting_.push_back(starting);
+  instances_ |= Lanes(1) << (starting_.size() - 1);
+  return starting_.size() - 1;
+}
+
+void
+graphplan::Batch_Graph::set_closed_world(bool closed)
+{
+  closed_world_ = closed;
+}
+
+bool
+graphplan::Batch_Graph::is_closed_world() const
+{
+  return closed_world_;
+}
+
+unsigned int
+graphplan::Batch_Graph::get_instance_count() const
+{
+  return starting_.size();
+}
+
+unsigned int
+graphplan::Batch_Graph::get_goal_level(unsigned int lane) const
+{
+  return lane < goal_level_.size() ? goal_level_[lane] : npos;
+}
+
+unsigned int
+graphplan::Batch_Graph::get_leveled_off(unsigned int lane) const
+{
+  return lane < leveled_off_.size() ? leveled_off_[lane] : npos;
+}
+
+graphplan::Batch_Graph::Lanes
+graphplan::Batch_Graph::get_reached(const Proposition& p) const
+{
+  unsigned int literal = problem_.get_literal(p);
+  return literal < reached_.size() ? reached_[literal] : 0;
+}
+
+graphplan::Batch_Graph::Lanes
+graphplan::Batch_Graph::get_mutex(const Proposition& a,
+  const Proposition& b) const
+{
+  unsigned int i = problem_.get_literal(a);
+  unsigned int j = problem_.get_literal(b);
+  if(i >= problem_.literal_count || j >= problem_.literal_count)
+    return 0;
+  return prop_mutex(i, j);
+}
+
+unsigned int
+graphplan::Batch_Graph::expand(unsigned int iterations)
+{
+  compile();
+  goal_level_.assign(starting_.size(), npos);
+  leveled_off_.assign(starting_.size(), npos);
+
+  // every lane takes the same sweep until all of them are done
+  unsigned int levels = 0;
+  while(levels < iterations)
+  {
+    if(levels > 0)
+      iteration(levels - 1);
+    ++levels;
+    if(goal_check(levels - 1) == instances_)
+      break;
+  }
+
+  return levels;
+}
+
+void
+graphplan::Batch_Graph::compile()
+{
+  // literals are stored and interfere as they do in Graphplan, every lane
+  // shares the numbering of the atoms its starting state mentions
+  set<Proposition> mentioned;
+  for(const set<Proposition>& starting : starting_)
+    mentioned.insert(starting.begin(), starting.end());
+  problem_.compile(actions_, mentioned, goals_, closed_world_);
+  const unsigned int literal_count = problem_.literal_count;
+
+  // state invariants hold from one starting state, so each lane has its own
+  std::size_t prop_pairs = std::size_t(literal_count) *
+    (literal_count - (literal_count > 0)) / 2;
+  invariant_.assign(prop_pairs, 0);
+  reached_.assign(literal_count, 0);
+  for(unsigned int lane = 0; lane < starting_.size(); ++lane)
+  {
+    const Lanes bit = Lanes(1) << lane;
+    vector<unsigned int> initial;
+    problem_.get_initial(starting_[lane], initial);
+    for(unsigned int p : initial)
+      reached_[p] |= bit;
+
+    Mutex_Groups groups;
+    groups.synthesize(literal_count, initial, problem_.action_precondition_ids,
+      problem_.action_effect_ids, problem_.action_delete_ids,
+      problem_.action_count);
+    for(unsigned int g = 0; g < groups.size(); ++g)
+    {
+      const vector<unsigned int>& group = groups.get_group(g);
+      for(unsigned int i = 0; i < group.size(); ++i)
+        for(unsigned int j = 0; j < i; ++j)
+          invariant_[pair(group[i], group[j])] |= bit;
+    }
+  }
+
+  // real actions read their preconditions, no-ops their one literal
+  unsigned int indices = problem_.action_count + literal_count;
+  literal_ids_.resize(literal_count);
+  for(unsigned int p = 0; p < literal_count; ++p)
+    literal_ids_[p] = p;
+  reads_.assign(indices, Literal_Table::Range(0, 0));
+  for(unsigned int a = 0; a < problem_.action_count; ++a)
+    reads_[a] = problem_.action_precondition_ids.get(a);
+  for(unsigned int p = 0; p < literal_count; ++p)
+    reads_[problem_.action_count + p] = Literal_Table::Range(&literal_ids_[p],
+      &literal_ids_[p] + 1);
+
+  // the starting level has no actions and no mutex pairs
+  std::size_t action_pairs = std::size_t(indices) *
+    (indices - (indices > 0)) / 2;
+  applied_.assign(indices, 0);
+  prop_mutex_.assign(prop_pairs, 0);
+  action_mutex_.assign(action_pairs, 0);
+  next_applied_.resize(indices);
+  next_reached_.resize(literal_count);
+  next_prop_mutex_.resize(prop_pairs);
+  next_action_mutex_.resize(action_pairs);
+  supporters_.resize(literal_count);
+}
+
+void
+graphplan::Batch_Graph::iteration(unsigned int level)
+{
+  const unsigned int literal_count = problem_.literal_count;
+  const unsigned int action_count = problem_.action_count;
+  const unsigned int indices = action_count + literal_count;
+  const Literal_Table& preconditions = problem_.action_precondition_ids;
+
+  // an action is in a lane once its preconditions are and no two are mutex,
+  // a no-op is wherever its literal is
+  vector<Lanes>& applied = next_applied_;
+  for(unsigned int a = 0; a < action_count; ++a)
+  {
+    Literal_Table::Range pre = preconditions.get(a);
+    Lanes lanes = instances_;
+    for(const unsigned int* p = pre.begin(); p != pre.end() && lanes; ++p)
+    {
+      lanes &= reached_[*p];
+      for(const unsigned int* q = pre.begin(); q != p; ++q)
+        lanes &= ~prop_mutex(*p, *q);
+    }
+    applied[a] = lanes;
+  }
+  for(unsigned int p = 0; p < literal_count; ++p)
+    applied[action_count + p] = reached_[p];
+
+  // a pair stays apart in lanes where both members were present and not
+  // mutex before, so only lanes where it was mutex or a member is new are
+  // checked, every pair is written so the buffer needs no clearing
+  vector<Lanes>& action_mutex = next_action_mutex_;
+  for(unsigned int i = 0; i < indices; ++i)
+  {
+    Lanes fresh_i = applied[i] & ~applied_[i];
+    for(unsigned int j = 0; j < i; ++j)
+    {
+      std::size_t k = pair(i, j);
+      Lanes check = applied[i] & applied[j] &
+        (action_mutex_[k] | fresh_i | (applied[j] & ~applied_[j]));
+      if(check == 0 || problem_.interference.test(i, j))
+      {
+        action_mutex[k] = check;
+        continue;
+      }
+
+      // competing needs
+      Lanes competing = 0;
+      for(unsigned int mine : reads_[i])
+        for(unsigned int other : reads_[j])
+          competing |= prop_mutex(mine, other);
+      action_mutex[k] = check & competing;
+    }
+  }
+
+  // every effect of an action is in the lanes of the action
+  vector<Lanes>& reached = next_reached_;
+  vector<vector<unsigned int> >& supporters = supporters_;
+  for(unsigned int p = 0; p < literal_count; ++p)
+  {
+    reached[p] = reached_[p];
+    supporters[p].clear();
+    if(reached_[p] != 0)
+      supporters[p].push_back(action_count + p);
+    for(unsigned int a : problem_.literal_producers.get(p))
+    {
+      if(applied[a] == 0)
+        continue;
+      reached[p] |= applied[a];
+      supporters[p].push_back(a);
+    }
+  }
+
+  // a pair is mutex in the lanes where every pair of supporters present
+  // there is, lanes that gain a literal or lose a mutex have not leveled off
+  vector<Lanes>& prop_mutex = next_prop_mutex_;
+  Lanes changed = 0;
+  for(unsigned int i = 0; i < literal_count; ++i)
+  {
+    Lanes fresh_i = reached[i] & ~reached_[i];
+    changed |= fresh_i;
+    for(unsigned int j = 0; j < i; ++j)
+    {
+      std::size_t k = pair(i, j);
+      Lanes check = reached[i] & reached[j] &
+        (prop_mutex_[k] | fresh_i | (reached[j] & ~reached_[j]));
+      if(check == 0)
+      {
+        prop_mutex[k] = 0;
+        continue;
+      }
+
+      Lanes mutex = check & ((i ^ 1) == j ? ~Lanes(0) : invariant_[k]);
+      Lanes rest = check & ~mutex;
+      for(unsigned int s : supporters[i])
+      {
+        for(unsigned int t : supporters[j])
+        {
+          Lanes apart = s == t ? 0 : action_mutex[pair(s, t)];
+          rest &= apart | ~(applied[s] & applied[t]);
+        }
+        if(rest == 0)
+          break;
+      }
+      prop_mutex[k] = mutex | rest;
+      changed |= prop_mutex[k] ^ prop_mutex_[k];
+    }
+  }
+
+  for(unsigned int lane = 0; lane < starting_.size(); ++lane)
+    if((changed >> lane & 1) == 0 && leveled_off_[lane] == npos)
+      leveled_off_[lane] = level;
+
+  applied_.swap(next_applied_);
+  action_mutex_.swap(next_action_mutex_);
+  reached_.swap(next_reached_);
+  prop_mutex_.swap(next_prop_mutex_);
+}
+
+graphplan::Batch_Graph::Lanes
+graphplan::Batch_Graph::goal_check(unsigned int level)
+{
+  // lanes with every goal and no two goals mutex
+  Lanes found = instances_;
+  for(set<Proposition>::const_iterator g = goals_.cbegin();
+    g != goals_.cend(); ++g)
+  {
+    found &= get_reached(*g);
+    for(set<Proposition>::const_iterator h = goals_.cbegin(); h != g; ++h)
+      found &= ~get_mutex(*g, *h);
+  }
+
+  // once leveled off, goals missing or mutex never come together
+  Lanes done = 0;
+  for(unsigned int lane = 0; lane < starting_.size(); ++lane)
+  {
+    if((found >> lane & 1) != 0 && goal_level_[lane] == npos)
+      goal_level_[lane] = level;
+    if(goal_level_[lane] != npos || leveled_off_[lane] <= level)
+      done |= Lanes(1) << lane;
+  }
+
+  return done;
+}
@@ -0,0 +1,214 @@
+/**
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2014 Anton Dukeman
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * @file Bit_Kernels.cpp
+ * @author Anton Dukeman <anton.dukeman@gmail.com>
+ *
+ * Subset, intersection and population count over word arrays, vectorized
+ * for the instruction sets the running CPU supports
+ */
+
+#include "graphplan/Bit_Kernels.hpp"
+
+#if defined(__x86_64__) || defined(__i386__)
+#define GRAPHPLAN_X86_KERNELS
+#include <immintrin.h>
+#endif
+
+using std::size_t;
+using std::vector;
+
+typedef graphplan::Bit_Kernels::Word Word;
+
+const size_t graphplan::Bit_Kernels::MIN_WORDS;
+
+namespace
+{
+  bool
+  portable_is_subset(const Word* a, const Word* b, size_t words)
+  {
+    for(size_t k = 0; k < words; ++k)
+      if(a[k] & ~b[k])
+        return false;
+    return true;
+  }
+
+  bool
+  portable_intersects(const Word* a, const Word* b, size_t words)
+  {
+    for(size_t k = 0; k < words; ++k)
+      if(a[k] & b[k])
+        return true;
+    return false;
+  }
+
+  size_t
+  portable_count(const Word* a, size_t words)
+  {
+    size_t ret = 0;
+    for(size_t k = 0; k < words; ++k)
+      ret += __builtin_popcountll(a[k]);
+    return ret;
+  }
+
+  const graphplan::Bit_Kernels portable = {
+    "portable", portable_is_subset, portable_intersects, portable_count
+  };
+
+#ifdef GRAPHPLAN_X86_KERNELS
+  // each kernel handles whole vectors and leaves the tail to the portable
+  // loop, unaligned loads since words come from vectors and matrix rows
+
+  __attribute__((target("sse2"))) bool
+  sse2_is_subset(const Word* a, const Word* b, size_t words)
+  {
+    size_t k = 0;
+    for(; k + 2 <= words; k += 2)
+    {
+      __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + k));
+      __m128i y = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + k));
+      __m128i z = _mm_cmpeq_epi8(_mm_andnot_si128(y, x), _mm_setzero_si128());
+      if(_mm_movemask_epi8(z) != 0xffff)
+        return false;
+    }
+    return portable_is_subset(a + k, b + k, words - k);
+  }
+
+  __attribute__((target("sse2"))) bool
+  sse2_intersects(const Word* a, const Word* b, size_t words)
+  {
+    size_t k = 0;
+    for(; k + 2 <= words; k += 2)
+    {
+      __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + k));
+      __m128i y = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + k));
+      __m128i z = _mm_cmpeq_epi8(_mm_and_si128(x, y), _mm_setzero_si128());
+      if(_mm_movemask_epi8(z) != 0xffff)
+        return true;
+    }
+    return portable_intersects(a + k, b + k, words - k);
+  }
+
+  __attribute__((target("popcnt"))) size_t
+  popcnt_count(const Word* a, size_t words)
+  {
+    size_t ret = 0;
+    for(size_t k = 0; k < words; ++k)
+      ret += __builtin_popcountll(a[k]);
+    return ret;
+  }
+
+  __attribute__((target("avx2"))) bool
+  avx2_is_subset(const Word* a, const Word* b, size_t words)
+  {
+    size_t k = 0;
+    for(; k + 4 <= words; k += 4)
+    {
+      __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + k));
+      __m256i y = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + k));
+      if(!_mm256_testc_si256(y, x))
+        return false;
+    }
+    return portable_is_subset(a + k, b + k, words - k);
+  }
+
+  __attribute__((target("avx2"))) bool
+  avx2_intersects(const Word* a, const Word* b, size_t words)
+  {
+    size_t k = 0;
+    for(; k + 4 <= words; k += 4)
+    {
+      __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + k));
+      __m256i y = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + k));
+      if(!_mm256_testz_si256(x, y))
+        return true;
+    }
+    return portable_intersects(a + k, b + k, words - k);
+  }
+
+  __attribute__((target("avx512f"))) bool
+  avx512_is_subset(const Word* a, const Word* b, size_t words)
+  {
+    size_t k = 0;
+    for(; k + 8 <= words; k += 8)
+    {
+      __m512i x = _mm512_loadu_si512(a + k);
+      __m512i y = _mm512_loadu_si512(b + k);
+      if(_mm512_cmpneq_epi64_mask(_mm512_and_si512(x, y), x) != 0)
+        return false;
+    }
+    return portable_is_subset(a + k, b + k, words - k);
+  }
+
+  __attribute__((target("avx512f"))) bool
+  avx512_intersects(const Word* a, const Word* b, size_t words)
+  {
+    size_t k = 0;
+    for(; k + 8 <= words; k += 8)
+    {
+      __m512i x = _mm512_loadu_si512(a + k);
+      __m512i y = _mm512_loadu_si512(b + k);
+      if(_mm512_test_epi64_mask(x, y) != 0)
+        return true;
+    }
+    return portable_intersects(a + k, b + k, words - k);
+  }
+
+  const graphplan::Bit_Kernels sse2 = {
+    "sse2", sse2_is_subset, sse2_intersects, portable_count
+  };
+
+  const graphplan::Bit_Kernels avx2 = {
+    "avx2", avx2_is_subset, avx2_intersects, popcnt_count
+  };
+
+  const graphplan::Bit_Kernels avx512 = {
+    "avx512", avx512_is_subset, avx512_intersects, popcnt_count
+  };
+#endif
+}
+
+const graphplan::Bit_Kernels&
+graphplan::Bit_Kernels::best()
+{
+  static const Bit_Kernels& ret = *supported().back();
+  return ret;
+}
+
+vector<const graphplan::Bit_Kernels*>
+graphplan::Bit_Kernels::supported()
+{
+  vector<const Bit_Kernels*> ret(1, &portable);
+#ifdef GRAPHPLAN_X86_KERNELS
+  __builtin_cpu_init();
+  if(__builtin_cpu_supports("sse2"))
+    ret.push_back(&sse2);
+  if(__builtin_cpu_supports("avx2") && __builtin_cpu_supports("popcnt"))
+    ret.push_back(&avx2);
+  if(__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("popcnt"))
+    ret.push_back(&avx512);
+#endif
+  return ret;
+}
@@ -0,0 +1,181 @@
+/**
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2014 Anton Dukeman
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * @file Bitset.cpp
+ * @author Anton Dukeman <anton.dukeman@gmail.com>
+ *
+ * Dense dynamically sized bitset used for proposition layers
+ */
+
+#include "graphplan/Bitset.hpp"
+#include "graphplan/Bit_Kernels.hpp"
+
+#include <algorithm>
+
+using std::min;
+
+graphplan::Bitset::Bitset(unsigned int n) :
+  size_(n), words_((n + WORD_BITS - 1) / WORD_BITS, 0)
+{
+}
+
+void
+graphplan::Bitset::resize(unsigned int n)
+{
+  words_.resize((n + WORD_BITS - 1) / WORD_BITS, 0);
+  size_ = n;
+
+  // keep bits past the end clear so word operations can ignore size
+  if(n % WORD_BITS != 0)
+    words_.back() &= (Word(1) << (n % WORD_BITS)) - 1;
+}
+
+unsigned int
+graphplan::Bitset::size() const
+{
+  return size_;
+}
+
+void
+graphplan::Bitset::clear()
+{
+  std::fill(words_.begin(), words_.end(), 0);
+}
+
+bool
+graphplan::Bitset::any() const
+{
+  for(Word w : words_)
+    if(w != 0)
+      return true;
+  return false;
+}
+
+unsigned int
+graphplan::Bitset::count() const
+{
+  return words_count(words_.data(), words_.size());
+}
+
+bool
+graphplan::Bitset::is_subset_of(const Bitset& b) const
+{
+  unsigned int common = min(words_.size(), b.words_.size());
+  if(!words_subset(words_.data(), b.words_.data(), common))
+    return false;
+  for(unsigned int i = common; i < words_.size(); ++i)
+    if(words_[i] != 0)
+      return false;
+  return true;
+}
+
+bool
+graphplan::Bitset::intersects(const Bitset& b) const
+{
+  unsigned int common = min(words_.size(), b.words_.size());
+  return words_intersect(words_.data(), b.words_.data(), common);
+}
+
+graphplan::Bitset&
+graphplan::Bitset::operator|=(const Bitset& b)
+{
+  if(b.size_ > size_)
+    resize(b.size_);
+  for(unsigned int i = 0; i < b.words_.size(); ++i)
+    words_[i] |= b.words_[i];
+  return *this;
+}
+
+graphplan::Bitset&
+graphplan::Bitset::operator&=(const Bitset& b)
+{
+  unsigned int common = min(words_.size(), b.words_.size());
+  for(unsigned int i = 0; i < common; ++i)
+    words_[i] &= b.words_[i];
+  for(unsigned int i = common; i < words_.size(); ++i)
+    words_[i] = 0;
+  return *this;
+}
+
+bool
+graphplan::Bitset::operator==(const Bitset& b) const
+{
+  const std::vector<Word>& small = 
+    words_.size() < b.words_.size() ? words_ : b.words_;
+  const std::vector<Word>& large = 
+    words_.size() < b.words_.size() ? b.words_ : words_;
+  for(unsigned int i = 0; i < small.size(); ++i)
+    if(small[i] != large[i])
+      return false;
+  for(unsigned int i = small.size(); i < large.size(); ++i)
+    if(large[i] != 0)
+      return false;
+  return true;
+}
+
+bool
+graphplan::Bitset::operator!=(const Bitset& b) const
+{
+  return !(this->operator==(b));
+}
+
+unsigned int
+graphplan::Bitset::find_first() const
+{
+  for(unsigned int i = 0; i < words_.size(); ++i)
+    if(words_[i] != 0)
+      return i * WORD_BITS + __builtin_ctzll(words_[i]);
+  return npos;
+}
+
+unsigned int
+graphplan::Bitset::find_next(unsigned int i) const
+{
+  ++i;
+  if(i >= size_)
+    return npos;
+
+  unsigned int word = i / WORD_BITS;
+  Word w = words_[word] & (~Word(0) << (i % WORD_BITS));
+  while(w == 0)
+  {
+    if(++word == words_.size())
+      return npos;
+    w = words_[word];
+  }
+  return word * WORD_BITS + __builtin_ctzll(w);
+}
+
+const graphplan::Bitset::Word*
+graphplan::Bitset::data() const
+{
+  return words_.data();
+}
+
+unsigned int
+graphplan::Bitset::word_count() const
+{
+  return words_.size();
+}
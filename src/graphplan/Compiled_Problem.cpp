@@ -0,0 +1,199 @@
+/**
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2014 Anton Dukeman
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * @file Compiled_Problem.cpp
+ * @author Anton Dukeman <anton.dukeman@gmail.com>
+ *
+ * Actions and literals of a problem compiled to integer tables, shared by
+ * Graphplan and Batch_Graph, the atoms of a problem are numbered densely so
+ * its tables only grow with the problem
+ */
+
+#include "graphplan/Compiled_Problem.hpp"
+
+#include <algorithm>
+
+using std::set;
+using std::string;
+using std::vector;
+
+const unsigned int graphplan::Compiled_Problem::npos;
+
+graphplan::Compiled_Problem::Compiled_Problem() :
+  literal_count(0), closed_world(false), action_count(0)
+{
+}
+
+void
+graphplan::Compiled_Problem::compile(const set<Action>& actions,
+  const set<Proposition>& starting, const set<Proposition>& goals,
+  bool closed, const string& directory)
+{
+  closed_world = closed;
+  action_table.assign(actions.cbegin(), actions.cend());
+  action_count = action_table.size();
+
+  // atoms keep the order of their interned ids, so literals come in the
+  // same order whatever else was interned before
+  atoms.clear();
+  for(const Action& action : action_table)
+  {
+    for(const Proposition& p : action.get_preconditions())
+      atoms.push_back(p.get_atom());
+    for(const Proposition& p : action.get_effects())
+      atoms.push_back(p.get_atom());
+  }
+  for(const Proposition& p : starting)
+    atoms.push_back(p.get_atom());
+  for(const Proposition& p : goals)
+    atoms.push_back(p.get_atom());
+  std::sort(atoms.begin(), atoms.end());
+  atoms.erase(std::unique(atoms.begin(), atoms.end()), atoms.end());
+  literal_count = 2 * atoms.size();
+
+  // propositions are copied from the ones seen, never interned again
+  literals.assign(literal_count, Proposition());
+  auto name = [&](const Proposition& p)
+  {
+    unsigned int i = get_literal(p) & ~1u;
+    literals[i] = p;
+    literals[i].set_negated(false);
+    literals[i + 1] = p;
+    literals[i + 1].set_negated(true);
+  };
+  for(const Action& action : action_table)
+  {
+    for(const Proposition& p : action.get_preconditions())
+      name(p);
+    for(const Proposition& p : action.get_effects())
+      name(p);
+  }
+  for(const Proposition& p : starting)
+    name(p);
+  for(const Proposition& p : goals)
+    name(p);
+
+  // under the closed world assumption a negated literal is only stored when
+  // a precondition or goal needs it, otherwise a negated effect just deletes
+  stored.resize(literal_count);
+  stored.clear();
+  for(unsigned int i = 0; i < literal_count; ++i)
+    if(!closed_world || (i & 1) == 0)
+      stored.set(i);
+  for(const Action& action : action_table)
+    for(const Proposition& p : action.get_preconditions())
+      stored.set(get_literal(p));
+  for(const Proposition& p : goals)
+    stored.set(get_literal(p));
+
+  action_precondition_ids.clear();
+  literal_consumers.clear();
+  literal_producers.clear();
+  action_effect_ids.clear();
+  action_delete_ids.clear();
+  for(unsigned int i = 0; i < action_count; ++i)
+  {
+    const Action& action = action_table[i];
+    for(const Proposition& p : action.get_preconditions())
+    {
+      unsigned int literal = get_literal(p);
+      action_precondition_ids.add(i, literal);
+      literal_consumers.add(literal, i);
+    }
+
+    // an effect deletes the opposite literal if that is stored
+    for(const Proposition& p : action.get_effects())
+    {
+      unsigned int literal = get_literal(p);
+      if(stored.test(literal))
+      {
+        action_effect_ids.add(i, literal);
+        literal_producers.add(literal, i);
+      }
+      if(stored.test(literal ^ 1))
+        action_delete_ids.add(i, literal ^ 1);
+    }
+  }
+  action_precondition_ids.build(action_count);
+  literal_consumers.build(literal_count);
+  literal_producers.build(literal_count);
+  action_effect_ids.build(action_count);
+  action_delete_ids.build(action_count);
+
+  /**
+   * case 1: inconsistent effects - an action adds a proposition effect
+   *         that another action deletes
+   * case 2: interference - an action deletes a preconditon that another
+   *         action needs, the no-op of a literal needs it too
+   */
+  interference = Mutex_Matrix(action_count + literal_count, directory);
+  for(unsigned int i = 0; i < action_count; ++i)
+  {
+    for(unsigned int p : action_delete_ids.get(i))
+    {
+      for(unsigned int other : literal_producers.get(p))
+        interference.set(i, other);
+      for(unsigned int other : literal_consumers.get(p))
+        interference.set(i, other);
+      interference.set(i, action_count + p);
+    }
+  }
+}
+
+unsigned int
+graphplan::Compiled_Problem::get_literal(const Proposition& p) const
+{
+  auto it = std::lower_bound(atoms.begin(), atoms.end(), p.get_atom());
+  if(it == atoms.end() || *it != p.get_atom())
+    return npos;
+  return (unsigned int)(it - atoms.begin()) << 1 | (p.is_negated() ? 1 : 0);
+}
+
+void
+graphplan::Compiled_Problem::get_initial(const set<Proposition>& starting,
+  vector<unsigned int>& initial) const
+{
+  initial.clear();
+  for(const Proposition& p : starting)
+  {
+    unsigned int literal = get_literal(p);
+    if(literal != npos && stored.test(literal))
+      initial.push_back(literal);
+  }
+  if(!closed_world)
+    return;
+
+  // a stored negated literal holds initially unless its atom is mentioned
+  Bitset mentioned(atoms.size());
+  for(const Proposition& p : starting)
+  {
+    unsigned int literal = get_literal(p);
+    if(literal != npos)
+      mentioned.set(literal >> 1);
+  }
+  for(unsigned int i = 1; i < literal_count; i += 2)
+    if(stored.test(i) && !mentioned.test(i >> 1))
+      initial.push_back(i);
+}
@@ -34,11 +34,13 @@
 #include <sstream>
 #include <iostream>
 #include <queue>
-#include <stack>
+#include <algorithm>
+#include <future>
 
 #include "graphplan/Proposition.hpp"
 #include "graphplan/Action.hpp"
 
+using std::size_t;
 using std::cout;
 using std::endl;
 using std::string;
@@ -47,36 +49,172 @@ using std::endl;
 using std::set;
 using std::queue;
 using std::map;
-using std::stack;
+using std::vector;
 
-graphplan::Graphplan::Graphplan()
+const unsigned int graphplan::Graphplan::NO_LIMIT;
+
+graphplan::Graphplan::Graphplan() :
+  closed_world_(false), pipelined_(false), triple_mutexes_(false),
+  backjumping_(false), compiled_(false),
+  graph_(std::make_shared<Planning_Graph>()),
+  pool_(std::make_shared<Thread_Pool>()), status_(BUDGET_EXHAUSTED),
+  triple_prunes_(0), backjumps_(0)
 {
 }
 
 graphplan::Graphplan::~Graphplan()
 {
-  for(auto it = prop_nodes_.cbegin(); it != prop_nodes_.cend(); ++it)
-    delete *it;
-  for(auto it = act_nodes_.cbegin(); it != act_nodes_.cend(); ++it)
-    delete *it;
 }
 
 void
 graphplan::Graphplan::add_starting(const Proposition& p)
 {
   starting_.insert(p);
+  compiled_ = false;
 }
 
 void
 graphplan::Graphplan::add_goal(const Proposition& p)
 {
   goals_.insert(p);
+  nogoods_.clear();
+
+  // the graph only has to change for literals it does not store, the goal
+  // mask is rebuilt when it does
+  unsigned int literal = graph_->get_literal(p);
+  if(!compiled_ || literal == Compiled_Problem::npos ||
+    !graph_->stored.test(literal))
+  {
+    compiled_ = false;
+    return;
+  }
+  goal_mask_.set(literal);
+
+  // triples of goals are only candidates if they were goals when compiled
+  const Triple_Mutex& triples = graph_->triples;
+  for(unsigned int a = goal_mask_.find_first(); triple_mutexes_ &&
+    a != Bitset::npos; a = goal_mask_.find_next(a))
+  {
+    for(unsigned int b = goal_mask_.find_next(a); b != Bitset::npos;
+      b = goal_mask_.find_next(b))
+    {
+      if(a != literal && b != literal &&
+        triples.find(a, b, literal) == Triple_Mutex::npos)
+      {
+        compiled_ = false;
+      }
+    }
+  }
+}
+
+void
+graphplan::Graphplan::clear_goals()
+{
+  goals_.clear();
+  goal_mask_.clear();
+  nogoods_.clear();
 }
 
 void
 graphplan::Graphplan::add_action(const Action& a)
 {
   actions_.insert(a);
+  compiled_ = false;
+}
+
+void
+graphplan::Graphplan::remove_action(const Action& a)
+{
+  actions_.erase(a);
+
+  // the graph may be shared, so keep it and skip the action when searching
+  if(!compiled_)
+    return;
+  for(unsigned int i = 0; i < graph_->action_count; ++i)
+    if(graph_->action_table[i] == a)
+      disabled_.set(i);
+  nogoods_.clear();
+}
+
+graphplan::Graphplan
+graphplan::Graphplan::fork() const
+{
+  return *this;
+}
+
+void
+graphplan::Graphplan::set_closed_world(bool closed)
+{
+  closed_world_ = closed;
+  compiled_ = false;
+}
+
+bool
+graphplan::Graphplan::is_closed_world() const
+{
+  return closed_world_;
+}
+
+void
+graphplan::Graphplan::set_threads(unsigned int threads)
+{
+  pool_ = std::make_shared<Thread_Pool>(std::max(threads, 1u));
+}
+
+unsigned int
+graphplan::Graphplan::get_threads() const
+{
+  return pool_->size();
+}
+
+void
+graphplan::Graphplan::set_pipelined(bool pipelined)
+{
+  pipelined_ = pipelined;
+}
+
+bool
+graphplan::Graphplan::is_pipelined() const
+{
+  return pipelined_;
+}
+
+void
+graphplan::Graphplan::set_triple_mutexes(bool triples)
+{
+  triple_mutexes_ = triples;
+  compiled_ = false;
+}
+
+bool
+graphplan::Graphplan::has_triple_mutexes() const
+{
+  return triple_mutexes_;
+}
+
+void
+graphplan::Graphplan::set_backjumping(bool backjumping)
+{
+  backjumping_ = backjumping;
+}
+
+bool
+graphplan::Graphplan::has_backjumping() const
+{
+  return backjumping_;
+}
+
+void
+graphplan::Graphplan::set_scratch_directory(const string& directory)
+{
+  scratch_directory_ = directory;
+  compiled_ = false;
+}
+
+const string&
+graphplan::Graphplan::get_scratch_directory() const
+{
+  return scratch_directory_;
 }
 
 const set<graphplan::Proposition>&
@@ -100,93 +238,164 @@ graphplan::Graphplan::get_goals() const
 unsigned int
 graphplan::Graphplan::plan(unsigned int iterations, Partial_Order_Plan* plan)
 {
-  // init proposition nodes
-  set<Proposition_Node*> props;
-  for(set<Proposition>::iterator it = starting_.cbegin(); it != starting_.cend();
-    ++it)
-  {
-    Proposition_Node* p = new Proposition_Node(*it);
-    prop_nodes_.insert(p);
-    props.insert(p);
-  }
+  // levels already expanded, by this graph or a fork, are reused, forks
+  // sharing the graph extend it one at a time
+  compile_actions();
+  Planning_Graph& graph = *graph_;
+  std::lock_guard<std::mutex> guard(graph.lock);
 
   // while not at goal, perform another iteration
   unsigned int iter;
-  map<const Proposition_Node*, Action_Node*> actions;
-  bool goal = false;
+  vector<Supporters> actions;
+  status_ = BUDGET_EXHAUSTED;
+  triple_prunes_ = 0;
+  backjumps_ = 0;
   for(iter = 0; iter < iterations; ++iter)
   {
-    goal = goal_check(props, actions);
-    if(goal)
-      break;
-
-    set<Proposition_Node*> new_props;
-    set<Action_Node*> new_acts;
-    iteration(props, new_props, new_acts);
+    if(iter == graph.prop_levels.sizes.size())
+      iteration(iter - 1);
 
-    // store proposition nodes for later deletion
-    for(set<Proposition_Node*>::const_iterator it = new_props.cbegin();
-      it != new_props.cend(); ++it)
+    // once leveled off, goals missing or mutex never come together
+    unsigned int leveled = graph.leveled_off;
+    if(!has_goals(iter))
     {
-      prop_nodes_.insert(*it);
+      if(leveled <= iter)
+      {
+        status_ = UNSOLVABLE;
+        break;
+      }
+      continue;
     }
 
-    // store action nodes for later deletion
-    for(set<Action_Node*>::const_iterator it = new_acts.cbegin();
-      it != new_acts.cend(); ++it)
+    // the search reads neither the sizes nor the pending edges expand
+    // appends to, so the next level is built alongside it and published
+    // once the search is done
+    Staged_Level& next = graph.staged;
+    std::future<void> expansion;
+    bool pipelined = pipelined_ && iter + 1 == graph.prop_levels.sizes.size()
+      && iter + 1 < iterations;
+    if(pipelined)
     {
-      act_nodes_.insert(*it);
+      expansion = std::async(std::launch::async,
+        [this, iter, &next] { expand(iter, next); });
     }
 
-    props.swap(new_props);
-  }
-
-  if(goal)
-  {
-    stack<Action_Node*> action_sequence;
-    set<Proposition_Node*> preconditions;
-    auto p = props.cbegin();
-    while((*p)->get_causes().size() != 0)
+    // the fixpoint test needs the nogoods of the leveled off level to only
+    // grow, so a bounded table never drops them
+    if(leveled != Bitset::npos)
+      nogoods_.keep_level(leveled);
+    size_t nogoods = nogoods_.get_insert_count(leveled);
+    bool found = goal_check(graph.prop_levels.index, iter, actions);
+    if(pipelined)
     {
-      set<Action_Node*> cur;
-      for(Proposition_Node* q : props)
-      {
-        if(cur.find(actions[q]) == cur.cend())
-        {
-          cur.insert(actions[q]);
-          action_sequence.push(actions[q]);
-          if(actions[q] != 0)
-          {
-            for(auto r : actions[q]->get_preconditions())
-              preconditions.insert(r);
-          }
-        }
-      }
-
-      action_sequence.push(0); // mark ending of this step
-      props.swap(preconditions);
-      p = props.cbegin();
+      expansion.get();
+      publish(iter, next);
+    }
+    if(found)
+    {
+      status_ = FOUND;
+      break;
     }
 
-    // print out results if requested
-    if(plan != 0)
+    // past the leveled off level, a search that learns no new nogood there
+    // fails the same way in every later level
+    if(leveled < iter && nogoods_.get_insert_count(leveled) == nogoods)
     {
-      unsigned int stage = 0;
-      while(action_sequence.size() > 1)
-      {
-        Action_Node* cur = action_sequence.top();
-        if(cur == 0)
-          ++stage;
-        else if(!(cur->get_action().is_maintenance_action()))
-          plan->add_action(stage - 1, cur->get_action());
-        action_sequence.pop();
-      }
+      status_ = UNSOLVABLE;
+      break;
     }
   }
 
+  // each level chose the actions of one stage
+  if(status_ == FOUND && plan != 0)
+  {
+    for(unsigned int level = iter; level > 0; --level)
+      for(auto pc : actions[level])
+        if(!Action_Node::is_noop(pc.second))
+          plan->add_action(level - 1, graph.action_table[pc.second]);
+  }
+
   return iter;
 }
 
+graphplan::Graphplan::Status
+graphplan::Graphplan::get_status() const
+{
+  return status_;
+}
+
+unsigned int
+graphplan::Graphplan::get_leveled_off() const
+{
+  return graph_->leveled_off;
+}
+
+size_t
+graphplan::Graphplan::get_nogood_count(unsigned int level) const
+{
+  return nogoods_.size(level);
+}
+
+void
+graphplan::Graphplan::set_nogood_limit(size_t bytes)
+{
+  nogoods_.set_limit(bytes);
+}
+
+size_t
+graphplan::Graphplan::get_nogood_limit() const
+{
+  return nogoods_.get_limit();
+}
+
+size_t
+graphplan::Graphplan::get_nogood_memory() const
+{
+  return nogoods_.get_memory();
+}
+
+unsigned int
+graphplan::Graphplan::get_triple_count() const
+{
+  return graph_->triples.size();
+}
+
+size_t
+graphplan::Graphplan::get_triple_mutex_count(unsigned int level) const
+{
+  return graph_->triples.count(level);
+}
+
+size_t
+graphplan::Graphplan::get_triple_prune_count() const
+{
+  return triple_prunes_;
+}
+
+size_t
+graphplan::Graphplan::get_backjump_count() const
+{
+  return backjumps_;
+}
+
+const graphplan::Node_Arena&
+graphplan::Graphplan::get_arena() const
+{
+  return graph_->arena;
+}
+
+const graphplan::Layer_Engine*
+graphplan::Graphplan::get_layer_engine() const
+{
+  return &graph_->layer_engine;
+}
+
+const graphplan::Mutex_Groups&
+graphplan::Graphplan::get_mutex_groups() const
+{
+  return graph_->mutex_groups;
+}
+
 string
 graphplan::Graphplan::to_string() const
 {
@@ -223,123 +432,467 @@ graphplan::Graphplan::to_string() const
 }
 
 void
-graphplan::Graphplan::iteration(const set<Proposition_Node*>& props,
-  set<Proposition_Node*>& new_props, set<Action_Node*>& new_actions)
-{
-  // handle maintenance actions
-  // copy each of the nodes
-  for(set<Proposition_Node*>::iterator it = props.cbegin();
-    it != props.cend(); ++it)
-  {
-    Proposition p = (*it)->get_proposition();
-    Proposition_Node* pn = new Proposition_Node(p);
-    Action maintenance;
-    maintenance.add_precondition(p);
-    maintenance.add_effect(p);
-    Action_Node* maint = new Action_Node("maintenance_" + (*it)->get_name());
-    maint->add_precondition(*it);
-    maint->add_effect(pn);
-    pn->add_cause(maint);
-    make_action_mutex_connections(new_actions, maint);
-    new_props.insert(pn);
-    new_actions.insert(maint);
-  }
-
-  // foreach action
-  for(set<Action>::const_iterator action = actions_.cbegin();
-    action != actions_.cend(); ++action)
+graphplan::Graphplan::compile_actions()
+{
+  if(compiled_)
+    return;
+
+  // forks may still be reading the old graph
+  if(graph_.use_count() > 1)
+    graph_ = std::make_shared<Planning_Graph>();
+  Planning_Graph& graph = *graph_;
+
+  graph.compile(actions_, starting_, goals_, closed_world_,
+    scratch_directory_);
+  graph.get_initial(starting_, graph.initial);
+  goal_mask_.resize(graph.literal_count);
+  goal_mask_.clear();
+  for(const Proposition& p : goals_)
+    goal_mask_.set(graph.get_literal(p));
+  graph.action_preconditions.clear();
+  for(unsigned int i = 0; i < graph.action_count; ++i)
   {
-    // foreach precondition
-    const set<Proposition>& preconds = action->get_preconditions();
-    bool good = true;
-    set <Proposition_Node*> found_precond;
-    for(set<Proposition>::const_iterator precond = preconds.cbegin();
-      precond != preconds.cend() && good; ++precond)
+    Bitset preconditions(graph.literal_count);
+    for(unsigned int p : graph.action_precondition_ids.get(i))
+      preconditions.set(p);
+    graph.action_preconditions.push_back(preconditions);
+  }
+
+  // real actions read the preconditions of their action, no-ops read the
+  // one literal they carry forward
+  graph.literal_ids.resize(graph.literal_count);
+  for(unsigned int p = 0; p < graph.literal_count; ++p)
+    graph.literal_ids[p] = p;
+  graph.reads.clear();
+  for(unsigned int i = 0; i < graph.action_count; ++i)
+    graph.reads.push_back(graph.action_precondition_ids.get(i));
+  for(unsigned int p = 0; p < graph.literal_count; ++p)
+    graph.reads.push_back(Literals(&graph.literal_ids[p],
+      &graph.literal_ids[p] + 1));
+
+  // literals of one mutex group never need their pairs checked per level
+  graph.mutex_groups.synthesize(graph.literal_count, graph.initial,
+    graph.action_precondition_ids, graph.action_effect_ids,
+    graph.action_delete_ids, graph.action_count);
+
+  // only triples an action reads together or the goals need together are
+  // worth knowing to be mutex
+  graph.triples.clear();
+  if(triple_mutexes_)
+  {
+    for(unsigned int i = 0; i < graph.action_count; ++i)
     {
-      // foreach proposition, check for match
-      good = false;
-      for(set<Proposition_Node*>::const_iterator prop = props.cbegin();
-        prop != props.cend() && !good; ++prop)
-      {
-        good = (*prop)->instance_of(*precond);
-        if(good)
-          found_precond.insert(*prop);
-      }
+      Literals preconditions = graph.action_precondition_ids.get(i);
+      graph.triples.add_candidates(vector<unsigned int>(
+        preconditions.begin(), preconditions.end()));
     }
-
-    // if all preconditions are present and not mutex
-    if(good && !(is_mutex(found_precond)))
+    vector<unsigned int> goals;
+    for(unsigned int p = goal_mask_.find_first(); p != Bitset::npos;
+      p = goal_mask_.find_next(p))
     {
-      // create action node and add result nodes
-      Action_Node* an = new Action_Node(*action);
-      connect_preconditions(found_precond, an);
-      connect_effect_nodes(*action, new_props, an);
-      make_action_mutex_connections(new_actions, an);
+      goals.push_back(p);
+    }
+    graph.triples.add_candidates(goals);
+  }
+  graph.triples.build();
 
-      new_actions.insert(an);
+  graph.layer_engine = Layer_Engine(graph.action_preconditions,
+    graph.literal_count);
+  graph.arena.set_scratch_directory(scratch_directory_);
+  disabled_.resize(graph.action_count);
+  disabled_.clear();
+  nogoods_.clear();
+
+  // the starting level, nothing is mutex in it
+  clear_graph();
+  for(unsigned int p : graph.initial)
+    add_proposition_node(p, 0);
+  graph.prop_levels.sizes.push_back(graph.prop_levels.nodes.size());
+  graph.prop_levels.causes.build(graph.literal_count);
+  Mutex_Matrix mutex(graph.literal_count,
+    graph.arena.get_scratch_directory());
+  graph.prop_levels.mutex.push_level(mutex);
+  Bitset triple_mutex(graph.triples.size());
+  graph.triples.push_level(triple_mutex);
+
+  compiled_ = true;
+}
+
+bool
+graphplan::Graphplan::has_goals(unsigned int level) const
+{
+  const Planning_Graph& graph = *graph_;
+
+  if(level + 1 == graph.prop_levels.sizes.size())
+  {
+    if(!graph.layer_engine.has_goals(goal_mask_, graph.prop_levels.layer,
+      graph.prop_levels.mutex.last()))
+    {
+      return false;
+    }
+  }
+  else
+  {
+    // a fork may have expanded past this level, so look at the nodes
+    for(unsigned int p = goal_mask_.find_first(); p != Bitset::npos;
+      p = goal_mask_.find_next(p))
+    {
+      const Proposition_Node* node = graph.prop_levels.index[p];
+      if(node == 0 || node->get_level() > level)
+        return false;
     }
+    if(graph.prop_levels.mutex.has_mutex(goal_mask_, level))
+      return false;
+  }
+
+  // no three goals may be mutex either
+  if(graph.triples.size() == 0)
+    return true;
+  vector<unsigned int> goals;
+  for(unsigned int p = goal_mask_.find_first(); p != Bitset::npos;
+    p = goal_mask_.find_next(p))
+  {
+    goals.push_back(p);
+  }
+  return !graph.triples.has_mutex(goals, level);
+}
+
+unsigned int
+graphplan::Graphplan::action_index(unsigned int id) const
+{
+  if(Action_Node::is_noop(id))
+    return graph_->action_count + (id & ~Action_Node::NOOP);
+  return id;
+}
+
+void
+graphplan::Graphplan::clear_graph()
+{
+  Planning_Graph& graph = *graph_;
+  const string& directory = graph.arena.get_scratch_directory();
+
+  graph.arena.reset();
+
+  graph.prop_levels.layer.resize(graph.literal_count);
+  graph.prop_levels.layer.clear();
+  graph.prop_levels.nodes.clear();
+  graph.prop_levels.sizes.clear();
+  graph.prop_levels.index.assign(graph.literal_count, 0);
+  graph.prop_levels.mutex.resize(graph.literal_count, directory);
+  graph.prop_levels.causes.clear();
+
+  graph.action_levels.nodes.clear();
+  graph.action_levels.sizes.clear();
+  graph.action_levels.mutex.resize(graph.action_count + graph.literal_count,
+    directory);
+  graph.action_levels.preconditions.clear();
+
+  graph.triples.clear_levels();
+  graph.staged = Staged_Level();
+  graph.leveled_off = Bitset::npos;
+
+  // actions without preconditions are applicable from the start
+  graph.unreached.resize(graph.action_count);
+  graph.triggered.clear();
+  for(unsigned int i = 0; i < graph.action_count; ++i)
+  {
+    graph.unreached[i] = graph.action_precondition_ids.get(i).size();
+    if(graph.unreached[i] == 0)
+      graph.triggered.push_back(i);
+  }
+}
+
+void
+graphplan::Graphplan::iteration(unsigned int level)
+{
+  expand(level, graph_->staged);
+  publish(level, graph_->staged);
+}
+
+void
+graphplan::Graphplan::expand(unsigned int level, Staged_Level& next)
+{
+  Planning_Graph& graph = *graph_;
+
+  // every node persists through its no-op, only new nodes are created
+  const Mutex_Matrix& mutex = graph.prop_levels.mutex.last();
+
+  // foreach triggered action with no two preconditions mutex, in id order
+  // as the search tries causes in the order they were created
+  vector<unsigned int> applicable;
+  find_applicable(mutex, applicable);
+  std::sort(applicable.begin(), applicable.end());
+  if(graph.triples.size() != 0)
+    hold_triple_mutex(level, applicable);
+  for(unsigned int i : applicable)
+  {
+    // foreach precondition
+    const Action* action = &graph.action_table[i];
+    set <Proposition_Node*> found_precond;
+    for(unsigned int precond : graph.action_precondition_ids.get(i))
+      found_precond.insert(graph.prop_levels.index[precond]);
+
+    // create action node and add result nodes
+    Action_Node* an = graph.arena.create<Action_Node>(*action, i, level);
+    connect_preconditions(found_precond, an);
+    connect_effect_nodes(an);
+    graph.action_levels.nodes.push_back(an);
+  }
+  graph.action_levels.sizes.push_back(graph.action_levels.nodes.size());
+  graph.prop_levels.sizes.push_back(graph.prop_levels.nodes.size());
+
+  // fold the new edges into rows of their own, the search reads the old
+  // rows until publish swaps them
+  graph.action_levels.preconditions.stage(graph.action_count,
+    next.preconditions);
+  graph.prop_levels.causes.stage(graph.literal_count, next.causes);
+
+  // publish hands back the matrices of an earlier level already cleared,
+  // so they are only allocated for the first level
+  const string& directory = graph.arena.get_scratch_directory();
+  if(next.action_mutex.size() != graph.action_count + graph.literal_count)
+  {
+    next.action_mutex = Mutex_Matrix(graph.action_count + graph.literal_count,
+      directory);
+  }
+  make_action_mutex_connections(level, mutex, next.action_mutex);
+
+  find_supporters(level, next.causes, next.supporters);
+  if(next.prop_mutex.size() != graph.literal_count)
+    next.prop_mutex = Mutex_Matrix(graph.literal_count, directory);
+  make_proposition_mutex_connections(level, next.supporters,
+    next.action_mutex, next.prop_mutex);
+
+  next.triple_mutex.resize(graph.triples.size());
+  make_triple_mutex_connections(level, next.supporters, next.action_mutex,
+    next.prop_mutex, next.triple_mutex);
+}
+
+void
+graphplan::Graphplan::hold_triple_mutex(unsigned int level,
+  vector<unsigned int>& applicable)
+{
+  Planning_Graph& graph = *graph_;
+
+  // actions reading three mutex literals wait with the triggered ones
+  vector<unsigned int> kept;
+  for(unsigned int i : applicable)
+  {
+    Literals preconditions = graph.action_precondition_ids.get(i);
+    vector<unsigned int> literals(preconditions.begin(), preconditions.end());
+    if(graph.triples.has_mutex(literals, level))
+      graph.triggered.push_back(i);
+    else
+      kept.push_back(i);
   }
+  applicable.swap(kept);
+}
+
+void
+graphplan::Graphplan::publish(unsigned int level, Staged_Level& next)
+{
+  Planning_Graph& graph = *graph_;
 
-  make_proposition_mutex_connections(new_props);
+  graph.action_levels.preconditions.swap(next.preconditions);
+  graph.prop_levels.causes.swap(next.causes);
+
+  graph.action_levels.mutex.push_level(next.action_mutex);
+  size_t pairs = graph.prop_levels.mutex.last().count();
+  graph.prop_levels.mutex.push_level(next.prop_mutex);
+  size_t triples = graph.triples.last().count();
+  graph.triples.push_level(next.triple_mutex);
+
+  // with no new proposition and no mutex gone every later level is the same
+  const vector<unsigned int>& sizes = graph.prop_levels.sizes;
+  if(graph.leveled_off == Bitset::npos && sizes[level] == sizes[level + 1] &&
+    graph.prop_levels.mutex.last().count() == pairs &&
+    graph.triples.last().count() == triples)
+  {
+    graph.leveled_off = level;
+  }
 }
 
 bool
 graphplan::Graphplan::goal_check(const set<Proposition_Node*>& props,
-  map<const Proposition_Node*, Action_Node*>& actions) const
+  vector<Supporters>& actions) const
 {
-  // foreach goal proposition
-  set<Proposition_Node*> found_goals;
-  for(set<Proposition>::const_iterator goal = goals_.cbegin(); goal != goals_.cend();
-    ++goal)
+  // goals mutex in the last level of the graph never hold together
+  const Planning_Graph& graph = *graph_;
+  if(!graph.prop_levels.sizes.empty())
   {
-    // search for goal in propositions
-    set<Proposition_Node*>::const_iterator it;
-    for(it = props.cbegin(); it != props.cend(); ++it)
+    Bitset goals(graph.literal_count);
+    for(const Proposition& goal : goals_)
     {
-      if((*it)->instance_of(*goal))
-        break;
+      unsigned int literal = graph.get_literal(goal);
+      if(literal != Compiled_Problem::npos)
+        goals.set(literal);
     }
+    if(is_mutex(goals, graph.prop_levels.mutex.last()))
+      return false;
+  }
+
+  return goal_check(props, Mutex_Matrix(), actions);
+}
 
-    // if we haven't found goal, then we are not in a goal state
+bool
+graphplan::Graphplan::goal_check(const set<Proposition_Node*>& props,
+  const Mutex_Matrix& mutex, vector<Supporters>& actions) const
+{
+  // check all goals are present, mutex holds the literal ids of the nodes
+  set<Proposition_Node*> found_goals;
+  Bitset goals;
+  for(const Proposition& goal : goals_)
+  {
+    auto it = props.cbegin();
+    while(it != props.cend() && !(*it)->instance_of(goal))
+      ++it;
     if(it == props.cend())
       return false;
-
-    // add goal to found
     found_goals.insert(*it);
+    goals.set((*it)->get_literal());
   }
 
   // ensure no mutex
-  if(!(is_mutex(found_goals)))
+  if(is_mutex(goals, mutex))
+    return false;
+
+  unsigned int level = graph_->prop_levels.sizes.empty() ? 0 :
+    graph_->prop_levels.sizes.size() - 1;
+  vector<Supporters> prop_causes(level + 1);
+  Nogood conflict;
+  if(level_goal_check(found_goals, level, prop_causes, conflict))
   {
-    map<const Proposition_Node*, Action_Node*> prop_causes;
-    if(level_goal_check(found_goals, prop_causes))
-    {
-      actions.swap(prop_causes);
-      return true;
-    }
+    actions.swap(prop_causes);
+    return true;
   }
 
   return false;
 }
 
 bool
-graphplan::Graphplan::is_mutex(const std::set<Proposition_Node*> props)
+graphplan::Graphplan::goal_check(const vector<Proposition_Node*>& index,
+  unsigned int level, vector<Supporters>& actions) const
 {
-  // ensure no mutex
-  for(auto g_1 = props.cbegin(); g_1 != props.cend(); ++g_1)
+  // foreach goal proposition
+  set<Proposition_Node*> found_goals;
+  for(unsigned int p = goal_mask_.find_first(); p != Bitset::npos;
+    p = goal_mask_.find_next(p))
   {
-    auto g_2 = g_1;
-    for(++g_2; g_2 != props.cend(); ++g_2)
-    {
-      if((*g_1)->get_mutex().find(*g_2) != (*g_1)->get_mutex().cend())
-        return true;
-    }
+    found_goals.insert(index[p]);
+  }
+
+  vector<Supporters> prop_causes(level + 1);
+  Nogood conflict;
+  if(level_goal_check(found_goals, level, prop_causes, conflict))
+  {
+    actions.swap(prop_causes);
+    return true;
   }
 
-  // if we reach here, then nothing is mutex
   return false;
 }
 
+bool
+graphplan::Graphplan::is_mutex(const Bitset& props, const Mutex_Matrix& mutex)
+{
+  return mutex.has_mutex(props);
+}
+
+bool
+graphplan::Graphplan::is_mutex(unsigned int my_index,
+  unsigned int other_index, const vector<Literals>& reads,
+  const vector<Bitset>& preconditions, const Mutex_Matrix& interference,
+  const Mutex_Matrix& prop_mutex)
+{
+  // cases 1 and 2 do not depend on the level
+  if(interference.test(my_index, other_index))
+    return true;
+
+  /**
+   * case 3: competing needs - an action has preconditions that are mutex with
+   *         another actions preconditions
+   */
+  // a no-op reads one literal and has no set, so a real action is the set
+  if(other_index >= preconditions.size())
+    std::swap(my_index, other_index);
+  if(other_index >= preconditions.size())
+    return prop_mutex.test(*reads[my_index].begin(),
+      *reads[other_index].begin());
+  for(unsigned int mine : reads[my_index])
+    if(prop_mutex.intersects(mine, preconditions[other_index]))
+      return true;
+
+  return false;
+}
+
+void
+graphplan::Graphplan::find_applicable(const Mutex_Matrix& mutex,
+  vector<unsigned int>& applicable)
+{
+  Planning_Graph& graph = *graph_;
+
+  const unsigned int threads = pool_->size();
+  if(threads == 1 || graph.triggered.size() < threads)
+  {
+    graph.layer_engine.find_applicable(graph.triggered, mutex, applicable);
+    return;
+  }
+
+  // each thread takes a run of the triggered actions, joining the runs in
+  // order keeps the actions in the order one thread would leave them
+  vector<vector<unsigned int> > triggered(threads);
+  vector<vector<unsigned int> > found(threads);
+  unsigned int run = (graph.triggered.size() + threads - 1) / threads;
+  for(unsigned int t = 0; t < threads; ++t)
+  {
+    unsigned int begin = std::min<size_t>(t * run, graph.triggered.size());
+    unsigned int end = std::min<size_t>(begin + run, graph.triggered.size());
+    triggered[t].assign(graph.triggered.begin() + begin,
+      graph.triggered.begin() + end);
+  }
+  pool_->run(threads, [&](unsigned int thread)
+  {
+    graph.layer_engine.find_applicable(triggered[thread], mutex,
+      found[thread]);
+  });
+
+  graph.triggered.clear();
+  for(unsigned int t = 0; t < threads; ++t)
+  {
+    graph.triggered.insert(graph.triggered.end(), triggered[t].begin(),
+      triggered[t].end());
+    applicable.insert(applicable.end(), found[t].begin(), found[t].end());
+  }
+}
+
+void
+graphplan::Graphplan::set_mutex(Mutex_Matrix& mutex, unsigned int i,
+  unsigned int j, unsigned int threads)
+{
+  if(threads == 1)
+    mutex.set(i, j);
+  else
+    mutex.set_shared(i, j);
+}
+
+graphplan::Proposition_Node*
+graphplan::Graphplan::add_proposition_node(unsigned int p, unsigned int level)
+{
+  Planning_Graph& graph = *graph_;
+
+  Proposition_Node* node = graph.arena.create<Proposition_Node>(
+    graph.literals[p], level, p);
+  graph.prop_levels.nodes.push_back(node);
+  graph.prop_levels.index[p] = node;
+  graph.prop_levels.layer.set(p);
+
+  // only consumers of the new literal can have become applicable
+  for(unsigned int action : graph.literal_consumers.get(p))
+    if(--graph.unreached[action] == 0)
+      graph.triggered.push_back(action);
+  return node;
+}
+
 void
 graphplan::Graphplan::connect_preconditions(
   const set<Proposition_Node*>& found_precond, Action_Node* an)
@@ -347,256 +900,522 @@ graphplan::Graphplan::connect_preconditions(
   for(set<Proposition_Node*>::const_iterator precond = 
     found_precond.cbegin(); precond != found_precond.cend(); ++precond)
   {
-    an->add_precondition(*precond);
-    (*precond)->add_supply(an);
+    graph_->action_levels.preconditions.add(an->get_id(), *precond);
   }
 }
 
 void
-graphplan::Graphplan::connect_effect_nodes(const Action& action, 
-  set<Proposition_Node*>& new_props, Action_Node* an)
+graphplan::Graphplan::connect_effect_nodes(Action_Node* an)
 {
-  const set<Proposition>& effects = action.get_effects();
-  for(set<Proposition>::const_iterator effect = effects.cbegin();
-    effect != effects.cend(); ++effect)
-  {
-    // check if proposition is already added
-    set<Proposition_Node*>::const_iterator pro;
-    for(pro = new_props.cbegin(); pro != new_props.cend(); ++pro)
-    {
-      if((*pro)->instance_of(*effect))
-        break;
-    }
+  Planning_Graph& graph = *graph_;
 
-    // if already in ret set, then just connect to node
-    if(pro != new_props.cend())
-    {
-      (*pro)->add_cause(an);
-      an->add_effect(*pro);
-    }
-    else
-    {
-      Proposition_Node* p = new Proposition_Node(*effect);
-      new_props.insert(p);
-      p->add_cause(an);
-      an->add_effect(p);
-    }
+  // only stored effects get nodes, if already added just connect to it
+  for(unsigned int effect : graph.action_effect_ids.get(an->get_id()))
+  {
+    if(graph.prop_levels.index[effect] == 0)
+      add_proposition_node(effect, an->get_level() + 1);
+    graph.prop_levels.causes.add(effect, an);
   }
 }
 
 void
-graphplan::Graphplan::make_action_mutex_connections(
-  set<Action_Node*>& new_actions, Action_Node* an)
-{
-  // foreach other actions
-  for(Action_Node* other_action : new_actions)
-  {
-    const set<Proposition_Node*>& my_effects = an->get_effects();
-    const set<Proposition_Node*>& my_preconditions = an->get_preconditions();
-    const set<Proposition_Node*>& other_effects = other_action->get_effects();
-    const set<Proposition_Node*>& other_preconditions = 
-      other_action->get_preconditions();
-    bool is_mutex = false;
-    /**
-     * case 1: inconsistent effects - an action adds a proposition effect
-     *         that another action deletes or is negation of
-     */
-    for(const Proposition_Node* mine : my_effects)
+graphplan::Graphplan::make_action_mutex_connections(unsigned int level,
+  const Mutex_Matrix& prop_mutex, Mutex_Matrix& action_mutex) const
+{
+  const Planning_Graph& graph = *graph_;
+  const Proposition_Levels& props = graph.prop_levels;
+  const Action_Levels& acts = graph.action_levels;
+
+  // members of the previous action level come first, then the new ones
+  const vector<Literals>& reads = graph.reads;
+  unsigned int old_acts = level == 0 ? 0 : acts.sizes[level - 1];
+  unsigned int old_props = level == 0 ? 0 : props.sizes[level - 1];
+  vector<unsigned int> indices;
+  indices.reserve(acts.sizes[level] + props.sizes[level]);
+  for(unsigned int i = 0; i < old_acts; ++i)
+    indices.push_back(acts.nodes[i]->get_id());
+  for(unsigned int i = 0; i < old_props; ++i)
+  {
+    unsigned int p = props.nodes[i]->get_literal();
+    indices.push_back(action_index(Action_Node::noop_id(p)));
+  }
+  unsigned int old_size = indices.size();
+  for(unsigned int i = old_acts; i < acts.sizes[level]; ++i)
+    indices.push_back(acts.nodes[i]->get_id());
+  for(unsigned int i = old_props; i < props.sizes[level]; ++i)
+  {
+    unsigned int p = props.nodes[i]->get_literal();
+    indices.push_back(action_index(Action_Node::noop_id(p)));
+  }
+
+  // members are dealt out to the threads, a pair is set the same way
+  // whichever thread finds it
+  const unsigned int threads = pool_->size();
+  pool_->run(threads, [&](unsigned int thread)
+  {
+    for(unsigned int act_1 = thread; act_1 < indices.size();
+      act_1 += threads)
     {
-      for(const Proposition_Node* other : other_effects)
+      unsigned int i = indices[act_1];
+
+      // mutexes only disappear, so two earlier actions can only be mutex if
+      // they were in the previous level
+      if(act_1 < old_size)
       {
-        if(mine->get_proposition().is_negation_of(other->get_proposition()))
+        const Mutex_Matrix& previous = acts.mutex.last();
+        for(unsigned int j = previous.find_first(i); j != Bitset::npos;
+          j = previous.find_next(i, j))
         {
-          other_action->add_mutex(an);
-          an->add_mutex(other_action);
-          is_mutex = true;
+          if(is_mutex(i, j, reads, graph.action_preconditions,
+            graph.interference, prop_mutex))
+          {
+            set_mutex(action_mutex, i, j, threads);
+          }
         }
+        continue;
       }
-    }
-    if(is_mutex)
-      continue;
 
-    /**
-     * case 2: interference - an action deletes a preconditon that another 
-     *         action needs
-     */
-    for(const Proposition_Node* mine : my_preconditions)
-    {
-      for(const Proposition_Node* other : other_effects)
+      // foreach pair with a new action
+      for(unsigned int act_2 = 0; act_2 < act_1; ++act_2)
       {
-        if(mine->get_proposition().is_negation_of(other->get_proposition()))
+        unsigned int j = indices[act_2];
+        if(is_mutex(i, j, reads, graph.action_preconditions,
+          graph.interference, prop_mutex))
         {
-          other_action->add_mutex(an);
-          an->add_mutex(other_action);
-          is_mutex = true;
+          set_mutex(action_mutex, i, j, threads);
         }
       }
     }
-    for(const Proposition_Node* mine : my_effects)
+  });
+}
+
+void
+graphplan::Graphplan::find_supporters(unsigned int level,
+  const Edge_Table<Action_Node*>& causes,
+  vector<vector<unsigned int> >& supporters) const
+{
+  const Planning_Graph& graph = *graph_;
+  const Proposition_Levels& props = graph.prop_levels;
+
+  // a literal stays once it appears, so only its row is refilled and the
+  // rows keep their storage from level to level
+  supporters.resize(graph.literal_count);
+  for(unsigned int i = 0; i < props.sizes[level + 1]; ++i)
+  {
+    const Proposition_Node* node = props.nodes[i];
+    unsigned int p = node->get_literal();
+    supporters[p].clear();
+    if(node->get_level() <= level)
+      supporters[p].push_back(action_index(Action_Node::noop_id(p)));
+    for(const Action_Node* an : causes.get(p))
+      supporters[p].push_back(an->get_id());
+  }
+}
+
+void
+graphplan::Graphplan::make_proposition_mutex_connections(unsigned int level,
+  const vector<vector<unsigned int> >& supporters,
+  const Mutex_Matrix& action_mutex, Mutex_Matrix& prop_mutex) const
+{
+  const Planning_Graph& graph = *graph_;
+  const Proposition_Levels& props = graph.prop_levels;
+  const Mutex_Groups& groups = graph.mutex_groups;
+
+  // propositions are dealt out to the threads like actions, each keeping
+  // the supporters of its proposition as a set
+  const unsigned int threads = pool_->size();
+  pool_->run(threads, [&](unsigned int thread)
+  {
+    Bitset mine(action_mutex.size());
+    for(unsigned int prop_1 = thread; prop_1 < props.sizes[level + 1];
+      prop_1 += threads)
     {
-      for(const Proposition_Node* other : other_preconditions)
+      unsigned int i = props.nodes[prop_1]->get_literal();
+
+      // propositions of one mutex group never hold together, their pairs
+      // are set from the group and left out of the checks below
+      unsigned int group = groups.get_group_of(i);
+      if(group != Mutex_Groups::npos)
       {
-        if(mine->get_proposition().is_negation_of(other->get_proposition()))
+        for(unsigned int j : groups.get_group(group))
         {
-          other_action->add_mutex(an);
-          an->add_mutex(other_action);
-          is_mutex = true;
+          const Proposition_Node* node = props.index[j];
+          if(j != i && node != 0 && node->get_level() <= level + 1)
+            set_mutex(prop_mutex, i, j, threads);
         }
       }
-    }
-    if(is_mutex)
-      continue;
 
-    /**
-     * case 3: competing needs - an action has preconditions that are mutex with
-     *         another actions preconditions
-     */
-    for(const Proposition_Node* mine : my_preconditions)
-    {
-      for(const Proposition_Node* other : other_preconditions)
+      for(unsigned int a : supporters[i])
+        mine.set(a);
+
+      // two earlier propositions can only be mutex if they were before
+      if(prop_1 < props.sizes[level])
       {
-        const set<const Proposition_Node*>& mutex = mine->get_mutex();
-        if(mutex.find(other) != mutex.cend())
+        const Mutex_Matrix& previous = props.mutex.last();
+        for(unsigned int j = previous.find_first(i); j != Bitset::npos;
+          j = previous.find_next(i, j))
         {
-          other_action->add_mutex(an);
-          an->add_mutex(other_action);
-          is_mutex = true;
+          if(!groups.same_group(i, j) &&
+            is_mutex(i, mine, j, supporters[j], action_mutex))
+          {
+            set_mutex(prop_mutex, i, j, threads);
+          }
         }
       }
+      else
+      {
+        // foreach pair with a new proposition
+        for(unsigned int prop_2 = 0; prop_2 < prop_1; ++prop_2)
+        {
+          unsigned int j = props.nodes[prop_2]->get_literal();
+          if(!groups.same_group(i, j) &&
+            is_mutex(i, mine, j, supporters[j], action_mutex))
+          {
+            set_mutex(prop_mutex, i, j, threads);
+          }
+        }
+      }
+
+      for(unsigned int a : supporters[i])
+        mine.reset(a);
     }
-    if(is_mutex)
-      continue;
-  }
+  });
 }
 
 void
-graphplan::Graphplan::make_proposition_mutex_connections(
-  set<Proposition_Node*>& new_props)
+graphplan::Graphplan::make_triple_mutex_connections(unsigned int level,
+  const vector<vector<unsigned int> >& supporters,
+  const Mutex_Matrix& action_mutex, const Mutex_Matrix& prop_mutex,
+  Bitset& triple_mutex) const
 {
-  for(set<Proposition_Node*>::iterator prop_1 = new_props.begin();
-    prop_1 != new_props.end(); ++prop_1)
+  const Planning_Graph& graph = *graph_;
+  const Triple_Mutex& triples = graph.triples;
+  const Mutex_Matrix& previous = graph.prop_levels.mutex.last();
+
+  // candidates are dealt out to the threads, each keeping what it finds
+  const unsigned int threads = pool_->size();
+  vector<vector<unsigned int> > found(threads);
+  pool_->run(threads, [&](unsigned int thread)
   {
-    set<Proposition_Node*>::iterator prop_2 = prop_1;
-    for(++prop_2; prop_2 != new_props.end(); ++prop_2)
+    for(unsigned int t = thread; t < triples.size(); t += threads)
     {
-      /**
-       * case 1: propositions are mutex if they are negations of each other
-       */
-      if((*prop_1)->get_proposition().is_negation_of(
-        (*prop_2)->get_proposition()))
+      const Triple_Mutex::Triple& x = triples.get(t);
+      bool present = true;
+      bool fresh = false;
+      for(unsigned int p : x)
+      {
+        const Proposition_Node* node = graph.prop_levels.index[p];
+        present = present && node != 0;
+        fresh = fresh || (node != 0 && node->get_level() > level);
+      }
+
+      // a mutex pair already keeps the three apart
+      if(!present || prop_mutex.test(x[0], x[1]) ||
+        prop_mutex.test(x[0], x[2]) || prop_mutex.test(x[1], x[2]))
       {
-        (*prop_1)->add_mutex(*prop_2);
-        (*prop_2)->add_mutex(*prop_1);
         continue;
       }
 
-      /**
-       * case 2: all actions that could have created the proposition are pairwise
-       *         mutex
-       */
-      // get causes
-      const set<Action_Node*>& causes_1 = (*prop_1)->get_causes();
-      const set<Action_Node*>& causes_2 = (*prop_2)->get_causes();
-      set<Action_Node*> causes;
-      for(Action_Node* act_1 : causes_1)
-        causes.insert(act_1);
-      for(Action_Node* act_2 : causes_2)
-        causes.insert(act_2);
-
-      // check pairwise actions for mutex
-      if(causes.size() >= 2)
+      // three earlier literals can only be mutex if they were before
+      if(!fresh && !triples.test(t, level) && !previous.test(x[0], x[1]) &&
+        !previous.test(x[0], x[2]) && !previous.test(x[1], x[2]))
       {
-        bool found_pair = false;
-        for(set<Action_Node*>::const_iterator act_1 = causes.cbegin();
-          act_1 != causes.cend() && !found_pair; ++act_1)
-        {
-          set<Action_Node*>::const_iterator act_2 = act_1;
-          for(++act_2; act_2 != causes.cend() && !found_pair; ++act_2)
-          {
-            set<Action_Node*> mutex_set = (*act_1)->get_mutex();
-            found_pair = (mutex_set.find(*act_2) == mutex_set.cend());
-          }
-        }
-    
-        if(!found_pair)
-        {
-          (*prop_1)->add_mutex(*prop_2);
-          (*prop_2)->add_mutex(*prop_1);
-        }
+        continue;
+      }
+
+      if(is_mutex(x, supporters, action_mutex, level))
+        found[thread].push_back(t);
+    }
+  });
+
+  for(const vector<unsigned int>& mutex : found)
+    for(unsigned int t : mutex)
+      triple_mutex.set(t);
+}
+
+bool
+graphplan::Graphplan::is_mutex(const Triple_Mutex::Triple& triple,
+  const vector<vector<unsigned int> >& supporters,
+  const Mutex_Matrix& action_mutex, unsigned int level) const
+{
+  const Planning_Graph& graph = *graph_;
+
+  // real actions read their preconditions, no-ops their one literal
+  vector<unsigned int> literals;
+  auto read = [&](unsigned int index)
+  {
+    if(index >= graph.action_count)
+    {
+      literals.push_back(index - graph.action_count);
+      return;
+    }
+    for(unsigned int p : graph.action_precondition_ids.get(index))
+      literals.push_back(p);
+  };
+
+  // mutex if every choice of supporters has two mutex actions or reads
+  // three literals mutex in the level before
+  for(unsigned int a : supporters[triple[0]])
+  {
+    for(unsigned int b : supporters[triple[1]])
+    {
+      if(action_mutex.test(a, b))
+        continue;
+      for(unsigned int c : supporters[triple[2]])
+      {
+        if(action_mutex.test(a, c) || action_mutex.test(b, c))
+          continue;
+
+        literals.clear();
+        read(a);
+        read(b);
+        read(c);
+        std::sort(literals.begin(), literals.end());
+        literals.erase(std::unique(literals.begin(), literals.end()),
+          literals.end());
+        if(!graph.triples.has_mutex(literals, level))
+          return false;
       }
     }
   }
+
+  return true;
+}
+
+bool
+graphplan::Graphplan::is_mutex(unsigned int my_id,
+  const Bitset& my_supporters, unsigned int other_id,
+  const vector<unsigned int>& other_supporters,
+  const Mutex_Matrix& action_mutex) const
+{
+  /**
+   * case 1: propositions are mutex if they are negations of each other
+   */
+  if((my_id ^ 1) == other_id)
+    return true;
+
+  /**
+   * case 2: every action that could have created one proposition is mutex
+   *         with every action that could have created the other
+   */
+  for(unsigned int act : other_supporters)
+    if(!action_mutex.covers(act, my_supporters))
+      return false;
+
+  return true;
 }
 
 bool
 graphplan::Graphplan::level_goal_check(const set<Proposition_Node*>& props,
-  map<const Proposition_Node*, Action_Node*>& prop_causes)
+  unsigned int level, vector<Supporters>& prop_causes, Nogood& conflict) const
 {
   // check if we are at level 0
-  set<Proposition_Node*>::const_iterator p = props.cbegin();
-  if((*p)->get_causes().size() == 0)
+  if(level == 0 || props.empty())
     return true;
 
+  // goal sets holding one that failed before fail again
+  Nogood key;
+  if(is_nogood(props, level, key, conflict))
+    return false;
+
+  // pairwise consistent goal sets may still hold three mutex literals
+  unsigned int triple = graph_->triples.find_mutex(key, level);
+  if(triple != Triple_Mutex::npos)
+  {
+    ++triple_prunes_;
+    const Triple_Mutex::Triple& x = graph_->triples.get(triple);
+    if(backjumping_)
+      conflict.assign(x.begin(), x.end());
+    else
+      conflict.swap(key);
+    nogoods_.insert(level, conflict);
+    return false;
+  }
+
   // recursively call sub_level_goal_check
-  map<const Proposition_Node*, Action_Node*> causes;
-  if(sub_level_goal_check(props, props.cbegin(), causes))
+  prop_causes[level].clear();
+  Bitset selected(graph_->action_count + graph_->literal_count);
+  if(sub_level_goal_check(props, level, props.cbegin(), selected,
+    prop_causes, conflict))
   {
-    for(auto pc : causes)
-      prop_causes[pc.first] = pc.second;
     return true;
   }
+
+  // only the goals to blame are remembered, so the nogood is found in
+  // every goal set holding them
+  nogoods_.insert(level, backjumping_ ? conflict : key);
   return false;
 }
 
+bool
+graphplan::Graphplan::is_nogood(const set<Proposition_Node*>& props,
+  unsigned int level, Nogood& key, Nogood& found) const
+{
+  key.reserve(props.size());
+  for(const Proposition_Node* p : props)
+    key.push_back(p->get_literal());
+  std::sort(key.begin(), key.end());
+
+  // only an explained failure needs the nogood it matched
+  if(!backjumping_)
+    return nogoods_.contains_subset(level, key);
+  return nogoods_.get_subset(level, key, found);
+}
+
 bool
 graphplan::Graphplan::sub_level_goal_check(const set<Proposition_Node*>& props,
-  set<Proposition_Node*>::const_iterator cur,
-  map<const Proposition_Node*, Action_Node*>& prop_causes)
+  unsigned int level, set<Proposition_Node*>::const_iterator cur,
+  Bitset& selected, vector<Supporters>& prop_causes, Nogood& conflict) const
 {
   // check if done recursing in this function
   if(cur == props.cend())
   {
     set<Proposition_Node*> new_props;
-    for(const Proposition_Node* p : props)
-      for(Proposition_Node* cause : prop_causes[p]->get_preconditions())
-        new_props.insert(cause);
-    map<const Proposition_Node*, Action_Node*> new_prop_causes;
-    if(level_goal_check(new_props, new_prop_causes))
+    for(Proposition_Node* p : props)
     {
-      for(auto pc : new_prop_causes)
-        prop_causes[pc.first] = pc.second;
+      unsigned int id = prop_causes[level][p];
+      if(Action_Node::is_noop(id))
+      {
+        new_props.insert(p);
+        continue;
+      }
+
+      const Action_Levels& acts = graph_->action_levels;
+      for(Proposition_Node* cause : acts.preconditions.get(id))
+        new_props.insert(cause);
+    }
+
+    Nogood below;
+    if(level_goal_check(new_props, level - 1, prop_causes, below))
       return true;
+    if(!backjumping_)
+      return false;
+
+    // blame the goals whose supporters need a literal of the failure below
+    conflict.clear();
+    for(Proposition_Node* p : props)
+    {
+      unsigned int id = prop_causes[level][p];
+      if(needs_any(id, below))
+        conflict.push_back(p->get_literal());
     }
+    std::sort(conflict.begin(), conflict.end());
     return false;
   }
 
-  // find action for next proposition
-  for(Action_Node* act : (*cur)->get_causes())
+  // stop at the first supporter that works or at a failure cur is not to
+  // blame for, trying another supporter for cur cannot mend that one
+  const unsigned int p = (*cur)->get_literal();
+  Nogood blame;
+  if(backjumping_)
   {
-    // check if it's mutex with other already selected actions
-    set<Action_Node*> mutex_actions = act->get_mutex();
-    bool mutex = false;
-    for(Proposition_Node* p : props)
+    blame.reserve(props.size());
+    blame.push_back(p);
+  }
+  Nogood reason;
+  bool found = false;
+  auto stop = [&](unsigned int id)
+  {
+    found = select_supporter(props, level, cur, id, selected, prop_causes,
+      reason);
+    if(found)
+      return true;
+    if(!backjumping_)
+      return false;
+    if(!std::binary_search(reason.begin(), reason.end(), p))
     {
-      if(mutex_actions.find(prop_causes[p]) != mutex_actions.cend())
-      {
-        mutex = true;
-        break;
-      }
+      ++backjumps_;
+      conflict.swap(reason);
+      return true;
+    }
+
+    for(unsigned int r : reason)
+    {
+      auto it = std::lower_bound(blame.begin(), blame.end(), r);
+      if(it == blame.end() || *it != r)
+        blame.insert(it, r);
+    }
+    return false;
+  };
+
+  // find action for next proposition, trying the no-op first
+  if((*cur)->get_level() < level && stop(Action_Node::noop_id(p)))
+    return found;
+
+  // only actions in the level before can be causes
+  for(const Action_Node* act : graph_->prop_levels.causes.get(p))
+  {
+    if(act->get_level() < level && !disabled_.test(act->get_id()) &&
+      stop(act->get_id()))
+    {
+      return found;
     }
+  }
+
+  conflict.swap(blame);
+  return false;
+}
 
-    if(!mutex)
+bool
+graphplan::Graphplan::select_supporter(const set<Proposition_Node*>& props,
+  unsigned int level, set<Proposition_Node*>::const_iterator cur,
+  unsigned int id, Bitset& selected, vector<Supporters>& prop_causes,
+  Nogood& conflict) const
+{
+  // check if it's mutex with other already selected actions
+  unsigned int index = action_index(id);
+  const Leveled_Mutex& mutex = graph_->action_levels.mutex;
+  if(mutex.intersects(index, selected, level - 1))
+  {
+    if(!backjumping_)
+      return false;
+
+    // the first earlier goal whose supporter it is mutex with is to blame
+    const Supporters& causes = prop_causes[level];
+    conflict.clear();
+    for(auto it = causes.cbegin(); it != causes.cend(); ++it)
     {
-      prop_causes[*cur] = act;
-      auto next = cur;
-      ++next;
-      if(sub_level_goal_check(props, next, prop_causes))
+      if(mutex.test(index, action_index(it->second), level - 1))
       {
-        return true;
+        conflict.push_back(it->first->get_literal());
+        break;
       }
-      prop_causes[*cur] = 0;
     }
+    conflict.push_back((*cur)->get_literal());
+    if(conflict.size() == 2 && conflict[1] < conflict[0])
+      std::swap(conflict[0], conflict[1]);
+    return false;
+  }
+
+  // another proposition may already have selected this action
+  bool shared = selected.test(index);
+  selected.set(index);
+  prop_causes[level][*cur] = id;
+  auto next = cur;
+  ++next;
+  if(sub_level_goal_check(props, level, next, selected, prop_causes,
+    conflict))
+  {
+    return true;
+  }
+
+  prop_causes[level].erase(*cur);
+  if(!shared)
+    selected.reset(index);
+  return false;
+}
+
+bool
+graphplan::Graphplan::needs_any(unsigned int id, const Nogood& literals) const
+{
+  if(Action_Node::is_noop(id))
+  {
+    return std::binary_search(literals.begin(), literals.end(),
+      id & ~Action_Node::NOOP);
   }
 
+  for(unsigned int p : graph_->action_precondition_ids.get(id))
+    if(std::binary_search(literals.begin(), literals.end(), p))
+      return true;
   return false;
 }
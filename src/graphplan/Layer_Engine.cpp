@@ -0,0 +1,101 @@
+/**
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2014 Anton Dukeman
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * @file Layer_Engine.cpp
+ * @author Anton Dukeman <anton.dukeman@gmail.com>
+ *
+ * Applicability and goal tests on proposition layers, specialized on the
+ * bitset used to hold a layer
+ */
+
+#include "graphplan/Layer_Engine.hpp"
+
+using std::vector;
+
+graphplan::Layer_Engine::Layer_Engine() :
+  capacity_(0)
+{
+}
+
+graphplan::Layer_Engine::Layer_Engine(const vector<Bitset>& preconditions,
+  unsigned int literal_count) :
+  capacity_(0)
+{
+  // pick the narrowest sets that fit every literal id
+  if(literal_count <= Fixed_Bitset<1>::CAPACITY)
+  {
+    capacity_ = Fixed_Bitset<1>::CAPACITY;
+    compile(preconditions, narrow_);
+  }
+  else if(literal_count <= Fixed_Bitset<2>::CAPACITY)
+  {
+    capacity_ = Fixed_Bitset<2>::CAPACITY;
+    compile(preconditions, medium_);
+  }
+  else if(literal_count <= Fixed_Bitset<4>::CAPACITY)
+  {
+    capacity_ = Fixed_Bitset<4>::CAPACITY;
+    compile(preconditions, broad_);
+  }
+  else
+  {
+    wide_ = preconditions;
+  }
+}
+
+void
+graphplan::Layer_Engine::find_applicable(vector<unsigned int>& triggered,
+  const Mutex_Matrix& mutex, vector<unsigned int>& applicable) const
+{
+  switch(capacity_)
+  {
+  case Fixed_Bitset<1>::CAPACITY:
+    find_applicable(narrow_, triggered, mutex, applicable);
+    break;
+  case Fixed_Bitset<2>::CAPACITY:
+    find_applicable(medium_, triggered, mutex, applicable);
+    break;
+  case Fixed_Bitset<4>::CAPACITY:
+    find_applicable(broad_, triggered, mutex, applicable);
+    break;
+  default:
+    find_applicable(wide_, triggered, mutex, applicable);
+    break;
+  }
+}
+
+bool
+graphplan::Layer_Engine::has_goals(const Bitset& goals, const Bitset& layer,
+  const Mutex_Matrix& mutex) const
+{
+  // goals past the end of the layer are never in it
+  return goals.is_subset_of(layer) && !mutex.has_mutex(goals);
+}
+
+unsigned int
+graphplan::Layer_Engine::get_capacity() const
+{
+  return capacity_;
+}
@@ -0,0 +1,169 @@
+/**
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2014 Anton Dukeman
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * @file Leveled_Mutex.cpp
+ * @author Anton Dukeman <anton.dukeman@gmail.com>
+ *
+ * Mutex pairs of every level, stored as the last level plus the level each
+ * earlier pair stopped holding at
+ */
+
+#include "graphplan/Leveled_Mutex.hpp"
+
+#include <utility>
+
+using std::size_t;
+using std::string;
+using std::vector;
+
+typedef graphplan::Mutex_Matrix::Word Word;
+
+graphplan::Leveled_Mutex::Leveled_Mutex(unsigned int n) :
+  last_(n), levels_(0), ended_(n), ended_count_(0)
+{
+}
+
+void
+graphplan::Leveled_Mutex::resize(unsigned int n, const string& directory)
+{
+  last_ = Mutex_Matrix(n, directory);
+  levels_ = 0;
+  ended_.clear();
+  ended_.resize(n);
+  ended_count_ = 0;
+}
+
+unsigned int
+graphplan::Leveled_Mutex::size() const
+{
+  return last_.size();
+}
+
+unsigned int
+graphplan::Leveled_Mutex::get_levels() const
+{
+  return levels_;
+}
+
+void
+graphplan::Leveled_Mutex::push_level(Mutex_Matrix& mutex)
+{
+  // words of the old last level missing from the new one end here, each
+  // pair is kept in the rows of both its members
+  if(levels_ > 0)
+  {
+    for(unsigned int i = 1; i < last_.size(); ++i)
+    {
+      const Word* old_row = last_.row(i);
+      const Word* new_row = mutex.row(i);
+      unsigned int words = (i + Bitset::WORD_BITS - 1) / Bitset::WORD_BITS;
+      for(unsigned int w = 0; w < words; ++w)
+      {
+        Word gone = old_row[w] & ~new_row[w];
+        if(gone == 0)
+          continue;
+        end(i, w, gone);
+        ended_count_ += __builtin_popcountll(gone);
+        for(Word rest = gone; rest != 0; rest &= rest - 1)
+        {
+          unsigned int j = w * Bitset::WORD_BITS + __builtin_ctzll(rest);
+          end(j, i / Bitset::WORD_BITS, Word(1) << (i % Bitset::WORD_BITS));
+        }
+      }
+    }
+  }
+
+  std::swap(last_, mutex);
+  mutex.resize(last_.size());
+  ++levels_;
+}
+
+const graphplan::Mutex_Matrix&
+graphplan::Leveled_Mutex::last() const
+{
+  return last_;
+}
+
+bool
+graphplan::Leveled_Mutex::intersects(unsigned int i, const Bitset& s,
+  unsigned int level) const
+{
+  if(level >= levels_)
+    return false;
+  if(last_.intersects(i, s))
+    return true;
+  if(level + 1 == levels_ || i >= ended_.size())
+    return false;
+
+  // pairs that still held in level are words ending after it
+  const Word* w = s.data();
+  const vector<Ended>& row = ended_[i];
+  for(auto it = row.rbegin(); it != row.rend() && it->level > level; ++it)
+    if(it->word < s.word_count() && (it->bits & w[it->word]) != 0)
+      return true;
+  return false;
+}
+
+bool
+graphplan::Leveled_Mutex::has_mutex(const Bitset& s, unsigned int level) const
+{
+  if(level >= levels_)
+    return false;
+  if(last_.has_mutex(s))
+    return true;
+  if(level + 1 == levels_)
+    return false;
+
+  const Word* w = s.data();
+  for(unsigned int i = s.find_first(); i != Bitset::npos && i < ended_.size();
+    i = s.find_next(i))
+  {
+    const vector<Ended>& row = ended_[i];
+    for(auto it = row.rbegin(); it != row.rend() && it->level > level; ++it)
+      if(it->word < s.word_count() && (it->bits & w[it->word]) != 0)
+        return true;
+  }
+  return false;
+}
+
+size_t
+graphplan::Leveled_Mutex::count_ended() const
+{
+  return ended_count_;
+}
+
+void
+graphplan::Leveled_Mutex::end(unsigned int i, unsigned int word, Word bits)
+{
+  // rows are filled in order, so a word of this level is the last one
+  vector<Ended>& row = ended_[i];
+  if(!row.empty() && row.back().level == levels_ && row.back().word == word)
+  {
+    row.back().bits |= bits;
+    return;
+  }
+  Ended e = { word, levels_, bits };
+  row.push_back(e);
+}
@@ -0,0 +1,238 @@
+/**
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2014 Anton Dukeman
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * @file Mutex_Groups.cpp
+ * @author Anton Dukeman <anton.dukeman@gmail.com>
+ *
+ * State invariants found before planning, groups of literals of which at
+ * most one holds in any reachable state, so their pairs are mutex in every
+ * level
+ */
+
+#include "graphplan/Mutex_Groups.hpp"
+
+using std::vector;
+using std::set;
+
+const unsigned int graphplan::Mutex_Groups::npos;
+
+graphplan::Mutex_Groups::Mutex_Groups()
+{
+}
+
+void
+graphplan::Mutex_Groups::clear()
+{
+  groups_.clear();
+  group_of_.clear();
+  partners_.clear();
+}
+
+unsigned int
+graphplan::Mutex_Groups::find(vector<unsigned int>& component, unsigned int p)
+{
+  while(component[p] != p)
+  {
+    component[p] = component[component[p]];
+    p = component[p];
+  }
+  return p;
+}
+
+bool
+graphplan::Mutex_Groups::is_candidate(unsigned int a, unsigned int b) const
+{
+  return partners_[a].count(b) != 0;
+}
+
+void
+graphplan::Mutex_Groups::synthesize(unsigned int literal_count,
+  const vector<unsigned int>& initial, const Literal_Table& preconditions,
+  const Literal_Table& effects, const Literal_Table& deletes,
+  unsigned int action_count)
+{
+  clear();
+  partners_.resize(literal_count);
+  Bitset holds(literal_count);
+  for(unsigned int p : initial)
+    holds.set(p);
+
+  // literals an action moves between, by adding one and deleting another,
+  // may form a group, so start from every pair within those components
+  vector<unsigned int> component(literal_count);
+  for(unsigned int p = 0; p < literal_count; ++p)
+    component[p] = p;
+  Bitset reachable = holds;
+  for(unsigned int a = 0; a < action_count; ++a)
+  {
+    for(unsigned int p : effects.get(a))
+    {
+      reachable.set(p);
+      for(unsigned int q : deletes.get(a))
+      {
+        unsigned int cp = find(component, p);
+        unsigned int cq = find(component, q);
+        component[cp] = cq;
+      }
+    }
+  }
+
+  vector<vector<unsigned int> > members(literal_count);
+  for(unsigned int p = 0; p < literal_count; ++p)
+    members[find(component, p)].push_back(p);
+  for(const vector<unsigned int>& c : members)
+  {
+    for(unsigned int i = 0; i < c.size(); ++i)
+    {
+      for(unsigned int j = i + 1; j < c.size(); ++j)
+      {
+        // negations are mutex anyway
+        unsigned int p = c[i];
+        unsigned int q = c[j];
+        if((p ^ q) != 1 && !(holds.test(p) && holds.test(q)))
+        {
+          partners_[p].insert(q);
+          partners_[q].insert(p);
+        }
+      }
+    }
+  }
+
+  // drop pairs some action can make hold together until none can
+  bool changed = true;
+  while(changed)
+  {
+    changed = false;
+    for(unsigned int a = 0; a < action_count; ++a)
+    {
+      // an action whose preconditions never hold together is never applied
+      Literal_Table::Range pre = preconditions.get(a);
+      bool applicable = true;
+      for(const unsigned int* r = pre.begin(); applicable && r != pre.end();
+        ++r)
+      {
+        for(const unsigned int* s = r + 1; s != pre.end(); ++s)
+        {
+          if(is_candidate(*r, *s))
+          {
+            applicable = false;
+            break;
+          }
+        }
+      }
+      if(!applicable)
+        continue;
+
+      for(unsigned int p : effects.get(a))
+      {
+        vector<unsigned int> violated;
+        for(unsigned int q : partners_[p])
+        {
+          // q is false after the action if it is deleted, or was false
+          // before and is not added
+          bool added = false;
+          for(unsigned int e : effects.get(a))
+            added = added || e == q;
+          if(added)
+          {
+            violated.push_back(q);
+            continue;
+          }
+
+          bool deleted = false;
+          for(unsigned int d : deletes.get(a))
+            deleted = deleted || d == q;
+          bool was_false = false;
+          for(unsigned int r : pre)
+            was_false = was_false || (r ^ q) == 1 || is_candidate(r, q);
+          if(!deleted && !was_false)
+            violated.push_back(q);
+        }
+
+        for(unsigned int q : violated)
+        {
+          partners_[p].erase(q);
+          partners_[q].erase(p);
+          changed = true;
+        }
+      }
+    }
+  }
+
+  // greedily partition reachable literals into groups of pairwise mutexes
+  group_of_.assign(literal_count, npos);
+  for(unsigned int p = reachable.find_first(); p != Bitset::npos;
+    p = reachable.find_next(p))
+  {
+    if(group_of_[p] != npos)
+      continue;
+
+    vector<unsigned int> group(1, p);
+    for(unsigned int q : partners_[p])
+    {
+      if(group_of_[q] != npos)
+        continue;
+
+      bool all = true;
+      for(unsigned int r : group)
+        all = all && (r == p || is_candidate(r, q));
+      if(all)
+        group.push_back(q);
+    }
+
+    for(unsigned int q : group)
+      group_of_[q] = groups_.size();
+    groups_.push_back(group);
+  }
+
+  vector<set<unsigned int> >().swap(partners_);
+}
+
+unsigned int
+graphplan::Mutex_Groups::size() const
+{
+  return groups_.size();
+}
+
+const vector<unsigned int>&
+graphplan::Mutex_Groups::get_group(unsigned int g) const
+{
+  return groups_[g];
+}
+
+unsigned int
+graphplan::Mutex_Groups::get_group_of(unsigned int literal) const
+{
+  return literal < group_of_.size() ? group_of_[literal] : npos;
+}
+
+unsigned int
+graphplan::Mutex_Groups::count_pairs() const
+{
+  unsigned int ret = 0;
+  for(const vector<unsigned int>& group : groups_)
+    ret += group.size() * (group.size() - 1) / 2;
+  return ret;
+}
@@ -0,0 +1,190 @@
+/**
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2014 Anton Dukeman
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * @file Mutex_Matrix.cpp
+ * @author Anton Dukeman <anton.dukeman@gmail.com>
+ *
+ * Packed lower triangular bit matrix of mutex pairs for one level
+ */
+
+#include "graphplan/Mutex_Matrix.hpp"
+
+#include <algorithm>
+
+using std::size_t;
+using std::min;
+
+graphplan::Mutex_Matrix::Mutex_Matrix(unsigned int n,
+  const std::string& directory) :
+  size_(0), directory_(directory), words_(0)
+{
+  resize(n);
+}
+
+void
+graphplan::Mutex_Matrix::resize(unsigned int n)
+{
+  // row i only stores columns 0 to i - 1
+  size_ = n;
+  offsets_.resize(n + 1);
+  size_t offset = 0;
+  for(unsigned int i = 0; i < n; ++i)
+  {
+    offsets_[i] = offset;
+    offset += (i + Bitset::WORD_BITS - 1) / Bitset::WORD_BITS;
+  }
+  offsets_[n] = offset;
+
+  // heap words of the same size are cleared in place, a scratch file is
+  // replaced since a new one costs no pages until written
+  size_t bytes = offset * sizeof(Word);
+  if(storage_.size() == bytes && !storage_.is_mapped() && directory_.empty())
+    std::fill(words_, words_ + offset, Word(0));
+  else
+    Scratch_Buffer(bytes, directory_).swap(storage_);
+  words_ = reinterpret_cast<Word*>(storage_.data());
+}
+
+unsigned int
+graphplan::Mutex_Matrix::size() const
+{
+  return size_;
+}
+
+void
+graphplan::Mutex_Matrix::set(unsigned int i, unsigned int j)
+{
+  if(i < j)
+    std::swap(i, j);
+  if(i == j || i >= size_)
+    return;
+  words_[offsets_[i] + j / Bitset::WORD_BITS] |=
+    Word(1) << (j % Bitset::WORD_BITS);
+}
+
+void
+graphplan::Mutex_Matrix::set_shared(unsigned int i, unsigned int j)
+{
+  if(i < j)
+    std::swap(i, j);
+  if(i == j || i >= size_)
+    return;
+  __atomic_fetch_or(&words_[offsets_[i] + j / Bitset::WORD_BITS],
+    Word(1) << (j % Bitset::WORD_BITS), __ATOMIC_RELAXED);
+}
+
+const graphplan::Mutex_Matrix::Word*
+graphplan::Mutex_Matrix::row(unsigned int i) const
+{
+  return words_ + offsets_[i];
+}
+
+bool
+graphplan::Mutex_Matrix::intersects(unsigned int i, const Bitset& s) const
+{
+  if(i >= size_)
+    return false;
+
+  // columns below i are a contiguous run of words
+  const Word* r = row(i);
+  const Word* w = s.data();
+  unsigned int words = min<size_t>(offsets_[i + 1] - offsets_[i], s.word_count());
+  if(words_intersect(r, w, words))
+    return true;
+
+  // columns above i live in the rows of the other members
+  for(unsigned int j = s.find_next(i); j != Bitset::npos && j < size_;
+    j = s.find_next(j))
+  {
+    if(test(j, i))
+      return true;
+  }
+
+  return false;
+}
+
+bool
+graphplan::Mutex_Matrix::covers(unsigned int i, const Bitset& s) const
+{
+  if(s.test(i))
+    return false;
+  if(i >= size_)
+    return s.find_first() == Bitset::npos;
+
+  // whole words below i are compared at once, the word holding i only up
+  // to it
+  const Word* r = row(i);
+  const Word* w = s.data();
+  unsigned int full = min<unsigned int>(i / Bitset::WORD_BITS,
+    s.word_count());
+  if(!words_subset(w, r, full))
+    return false;
+  unsigned int bits = i % Bitset::WORD_BITS;
+  if(bits != 0 && full < s.word_count() &&
+    (w[full] & ((Word(1) << bits) - 1) & ~r[full]) != 0)
+  {
+    return false;
+  }
+
+  // columns above i live in the rows of the other members
+  for(unsigned int j = s.find_next(i); j != Bitset::npos; j = s.find_next(j))
+    if(!test(j, i))
+      return false;
+
+  return true;
+}
+
+unsigned int
+graphplan::Mutex_Matrix::find_first(unsigned int i) const
+{
+  return find_next(i, Bitset::npos);
+}
+
+unsigned int
+graphplan::Mutex_Matrix::find_next(unsigned int i, unsigned int k) const
+{
+  // npos wraps around to column 0
+  unsigned int j = k + 1;
+  if(i >= size_ || j >= i)
+    return Bitset::npos;
+
+  const Word* r = row(i);
+  size_t words = offsets_[i + 1] - offsets_[i];
+  size_t word = j / Bitset::WORD_BITS;
+  Word w = r[word] & (~Word(0) << (j % Bitset::WORD_BITS));
+  while(w == 0)
+  {
+    if(++word == words)
+      return Bitset::npos;
+    w = r[word];
+  }
+  return word * Bitset::WORD_BITS + __builtin_ctzll(w);
+}
+
+size_t
+graphplan::Mutex_Matrix::count() const
+{
+  return words_count(words_, offsets_[size_]);
+}
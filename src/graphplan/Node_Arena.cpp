@@ -0,0 +1,133 @@
+/**
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2014 Anton Dukeman
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * @file Node_Arena.cpp
+ * @author Anton Dukeman <anton.dukeman@gmail.com>
+ *
+ * Bump allocator owning the nodes of a planning graph
+ */
+
+#include "graphplan/Node_Arena.hpp"
+
+#include <algorithm>
+
+using std::size_t;
+using std::max;
+using std::string;
+
+const size_t graphplan::Node_Arena::MAPPED_BLOCK_SIZE;
+
+graphplan::Node_Arena::Node_Arena(size_t block_size) :
+  block_size_(block_size), current_(0), offset_(0), used_(0), high_water_(0),
+  stale_(false)
+{
+}
+
+void*
+graphplan::Node_Arena::allocate(size_t size, size_t align)
+{
+  while(current_ < blocks_.size())
+  {
+    Block& block = blocks_[current_];
+    size_t start = (offset_ + align - 1) / align * align;
+    if(start + size <= block.size())
+    {
+      used_ += start + size - offset_;
+      high_water_ = max(high_water_, used_);
+      offset_ = start + size;
+      return block.data() + start;
+    }
+
+    // move on to the next free block
+    ++current_;
+    offset_ = 0;
+  }
+
+  // no room anywhere, add a block big enough for this request
+  size_t block_size = max(block_size_, size + align);
+  if(!directory_.empty())
+    block_size = max(block_size, MAPPED_BLOCK_SIZE);
+  blocks_.push_back(Block(block_size, directory_));
+  return allocate(size, align);
+}
+
+void
+graphplan::Node_Arena::reset()
+{
+  if(stale_)
+  {
+    blocks_.clear();
+    stale_ = false;
+  }
+  current_ = 0;
+  offset_ = 0;
+  used_ = 0;
+}
+
+void
+graphplan::Node_Arena::set_scratch_directory(const string& directory)
+{
+  if(directory == directory_)
+    return;
+  directory_ = directory;
+
+  // nodes may still live in the blocks up to the current one
+  if(used_ == 0)
+  {
+    blocks_.clear();
+    current_ = 0;
+    offset_ = 0;
+    return;
+  }
+  blocks_.erase(blocks_.begin() + current_ + 1, blocks_.end());
+  stale_ = true;
+}
+
+const string&
+graphplan::Node_Arena::get_scratch_directory() const
+{
+  return directory_;
+}
+
+size_t
+graphplan::Node_Arena::get_used() const
+{
+  return used_;
+}
+
+size_t
+graphplan::Node_Arena::get_capacity() const
+{
+  size_t ret = 0;
+  for(const Block& block : blocks_)
+    ret += block.size();
+  return ret;
+}
+
+size_t
+graphplan::Node_Arena::get_high_water_mark() const
+{
+  return high_water_;
+}
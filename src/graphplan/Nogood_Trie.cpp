@@ -0,0 +1,331 @@
+/**
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2014 Anton Dukeman
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * @file Nogood_Trie.cpp
+ * @author Anton Dukeman <anton.dukeman@gmail.com>
+ *
+ * Goal sets known to fail in each level, kept in a set-trie so a goal set
+ * holding any of them is found without searching it
+ */
+
+#include "graphplan/Nogood_Trie.hpp"
+
+#include <algorithm>
+#include <utility>
+
+using std::vector;
+
+const std::size_t graphplan::Nogood_Trie::NO_LIMIT;
+const unsigned int graphplan::Nogood_Trie::NONE;
+
+graphplan::Nogood_Trie::Nogood_Trie(std::size_t limit) :
+  limit_(limit), high_water_(limit), kept_(NONE), clock_(0), evicted_(0)
+{
+}
+
+void
+graphplan::Nogood_Trie::set_limit(std::size_t bytes)
+{
+  limit_ = bytes;
+  high_water_ = limit_;
+  if(get_memory() > high_water_)
+    evict();
+}
+
+std::size_t
+graphplan::Nogood_Trie::get_limit() const
+{
+  return limit_;
+}
+
+void
+graphplan::Nogood_Trie::keep_level(unsigned int level)
+{
+  kept_ = level;
+}
+
+bool
+graphplan::Nogood_Trie::contains_subset(unsigned int level,
+  const Nogood& goals)
+{
+  if(level >= roots_.size() || roots_[level] == NONE)
+    return false;
+
+  unsigned int node = find_subset(roots_[level], goals, 0);
+  if(node == NONE)
+    return false;
+  nodes_[node].used = ++clock_;
+  return true;
+}
+
+bool
+graphplan::Nogood_Trie::get_subset(unsigned int level, const Nogood& goals,
+  Nogood& found)
+{
+  if(level >= roots_.size() || roots_[level] == NONE)
+    return false;
+
+  unsigned int node = find_subset(roots_[level], goals, 0);
+  if(node == NONE)
+    return false;
+  nodes_[node].used = ++clock_;
+
+  // the literals are on the path up to the root of the level
+  found.clear();
+  for(unsigned int n = node; nodes_[n].parent != NONE; n = nodes_[n].parent)
+    found.push_back(nodes_[n].literal);
+  std::reverse(found.begin(), found.end());
+  return true;
+}
+
+void
+graphplan::Nogood_Trie::insert(unsigned int level, const Nogood& goals)
+{
+  if(roots_.size() <= level)
+  {
+    roots_.resize(level + 1, NONE);
+    counts_.resize(level + 1, 0);
+    inserts_.resize(level + 1, 0);
+  }
+  if(roots_[level] == NONE)
+    roots_[level] = allocate(level, NONE);
+  ++inserts_[level];
+
+  // a nogood makes every nogood holding it redundant
+  vector<unsigned int> supersets;
+  find_supersets(roots_[level], goals, 0, supersets);
+  for(unsigned int node : supersets)
+    erase(node);
+
+  unsigned int node = roots_[level];
+  for(unsigned int literal : goals)
+    node = find_child(node, literal);
+  if(nodes_[node].used == 0)
+    ++counts_[level];
+  nodes_[node].used = ++clock_;
+
+  if(get_memory() > high_water_)
+    evict();
+}
+
+std::size_t
+graphplan::Nogood_Trie::size(unsigned int level) const
+{
+  return level < counts_.size() ? counts_[level] : 0;
+}
+
+std::size_t
+graphplan::Nogood_Trie::get_insert_count(unsigned int level) const
+{
+  return level < inserts_.size() ? inserts_[level] : 0;
+}
+
+std::size_t
+graphplan::Nogood_Trie::get_evict_count() const
+{
+  return evicted_;
+}
+
+std::size_t
+graphplan::Nogood_Trie::get_memory() const
+{
+  return (nodes_.size() - free_.size()) * sizeof(Node) +
+    roots_.size() * (sizeof(unsigned int) + 2 * sizeof(std::size_t));
+}
+
+void
+graphplan::Nogood_Trie::clear()
+{
+  nodes_.clear();
+  free_.clear();
+  roots_.clear();
+  counts_.clear();
+  inserts_.clear();
+  high_water_ = limit_;
+  kept_ = NONE;
+  clock_ = 0;
+  evicted_ = 0;
+}
+
+unsigned int
+graphplan::Nogood_Trie::allocate(unsigned int literal, unsigned int parent)
+{
+  Node node = {literal, parent, NONE, NONE, 0};
+  if(free_.empty())
+  {
+    nodes_.push_back(node);
+    return nodes_.size() - 1;
+  }
+
+  unsigned int n = free_.back();
+  free_.pop_back();
+  nodes_[n] = node;
+  return n;
+}
+
+unsigned int
+graphplan::Nogood_Trie::find_child(unsigned int node, unsigned int literal)
+{
+  // keep the children in literal id order
+  unsigned int previous = NONE;
+  unsigned int c = nodes_[node].child;
+  while(c != NONE && nodes_[c].literal < literal)
+  {
+    previous = c;
+    c = nodes_[c].sibling;
+  }
+  if(c != NONE && nodes_[c].literal == literal)
+    return c;
+
+  unsigned int n = allocate(literal, node);
+  nodes_[n].sibling = c;
+  if(previous == NONE)
+    nodes_[node].child = n;
+  else
+    nodes_[previous].sibling = n;
+  return n;
+}
+
+unsigned int
+graphplan::Nogood_Trie::find_subset(unsigned int node, const Nogood& goals,
+  unsigned int i) const
+{
+  if(nodes_[node].used != 0)
+    return node;
+
+  // children and goals are both sorted, so walk them together
+  unsigned int c = nodes_[node].child;
+  while(c != NONE && i < goals.size())
+  {
+    if(nodes_[c].literal < goals[i])
+    {
+      c = nodes_[c].sibling;
+    }
+    else if(nodes_[c].literal > goals[i])
+    {
+      ++i;
+    }
+    else
+    {
+      unsigned int found = find_subset(c, goals, i + 1);
+      if(found != NONE)
+        return found;
+      c = nodes_[c].sibling;
+      ++i;
+    }
+  }
+
+  return NONE;
+}
+
+void
+graphplan::Nogood_Trie::find_supersets(unsigned int node,
+  const Nogood& goals, unsigned int i, vector<unsigned int>& found) const
+{
+  if(i == goals.size() && nodes_[node].used != 0)
+    found.push_back(node);
+
+  // literals before the next goal may be skipped, later ones may not
+  for(unsigned int c = nodes_[node].child; c != NONE; c = nodes_[c].sibling)
+  {
+    if(i == goals.size() || nodes_[c].literal < goals[i])
+      find_supersets(c, goals, i, found);
+    else if(nodes_[c].literal == goals[i])
+      find_supersets(c, goals, i + 1, found);
+    else
+      break;
+  }
+}
+
+void
+graphplan::Nogood_Trie::erase(unsigned int node)
+{
+  unsigned int root = node;
+  while(nodes_[root].parent != NONE)
+    root = nodes_[root].parent;
+  --counts_[nodes_[root].literal];
+  nodes_[node].used = 0;
+
+  // free the nodes no other nogood goes through
+  while(node != root && nodes_[node].child == NONE && nodes_[node].used == 0)
+  {
+    unsigned int parent = nodes_[node].parent;
+    if(nodes_[parent].child == node)
+    {
+      nodes_[parent].child = nodes_[node].sibling;
+    }
+    else
+    {
+      unsigned int c = nodes_[parent].child;
+      while(nodes_[c].sibling != node)
+        c = nodes_[c].sibling;
+      nodes_[c].sibling = nodes_[node].sibling;
+    }
+    free_.push_back(node);
+    node = parent;
+  }
+}
+
+unsigned int
+graphplan::Nogood_Trie::level_of(unsigned int node) const
+{
+  while(nodes_[node].parent != NONE)
+    node = nodes_[node].parent;
+  return nodes_[node].literal;
+}
+
+void
+graphplan::Nogood_Trie::evict()
+{
+  // nothing to drop when every nogood is of the kept level
+  std::size_t droppable = 0;
+  for(unsigned int level = 0; level < counts_.size(); ++level)
+    if(level != kept_)
+      droppable += counts_[level];
+
+  // oldest first, free nodes and interior nodes are not nogoods
+  std::size_t target = limit_ - limit_ / 4;
+  if(droppable != 0)
+  {
+    vector<std::pair<std::size_t, unsigned int> > nogoods;
+    nogoods.reserve(droppable);
+    for(unsigned int n = 0; n < nodes_.size(); ++n)
+      if(nodes_[n].used != 0 && (kept_ == NONE || level_of(n) != kept_))
+        nogoods.push_back(std::make_pair(nodes_[n].used, n));
+    std::sort(nogoods.begin(), nogoods.end());
+
+    for(unsigned int k = 0; k < nogoods.size() && get_memory() > target; ++k)
+    {
+      erase(nogoods[k].second);
+      ++evicted_;
+    }
+  }
+
+  // the kept level alone may hold more than the bound, then wait for it to
+  // grow by a quarter before passing over the nodes again
+  std::size_t memory = get_memory();
+  high_water_ = memory > target ? std::max(limit_, memory + memory / 4) :
+    limit_;
+}
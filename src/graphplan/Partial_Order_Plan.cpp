@@ -72,7 +72,7 @@ graphplan::Partial_Order_Plan::to_string() const
   for(auto it = actions_.cbegin(); it != actions_.cend(); ++it)
   {
     ret << "Stage " << stage++ << endl;
-    for(const Action a : *it)
+    for(const Action& a : *it)
     {
       ret << "\t" << a.get_name() << endl;
     }
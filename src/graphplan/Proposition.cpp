@@ -33,17 +33,19 @@
 
 #include <string>
 
+#include "graphplan/Atom_Table.hpp"
+
 using std::string;
 
 graphplan::Proposition::Proposition(const std::string& n, const bool& neg) :
-  name_(n), negated_(neg)
+  id_((Atom_Table::instance().intern(n) << 1) | (neg ? 1 : 0))
 {
 }
 
 bool
 graphplan::Proposition::operator==(const Proposition& p) const
 {
-  return (name_.compare(p.name_) == 0) && (negated_ == p.negated_);
+  return id_ == p.id_;
 }
 
 bool
@@ -55,45 +57,53 @@ graphplan::Proposition::operator!=(const Proposition& p) const
 bool
 graphplan::Proposition::operator<(const Proposition& p) const
 {
-  if(name_ < p.name_)
-    return true;
-  if(name_ > p.name_)
-    return false;
-  return !negated_ && p.negated_;
+  return id_ < p.id_;
 }
 
 const string&
 graphplan::Proposition::get_name() const
 {
-  return name_;
+  return Atom_Table::instance().get_name(id_ >> 1);
+}
+
+unsigned int
+graphplan::Proposition::get_id() const
+{
+  return id_;
+}
+
+unsigned int
+graphplan::Proposition::get_atom() const
+{
+  return id_ >> 1;
 }
 
 bool
 graphplan::Proposition::is_negated() const
 {
-  return negated_;
+  return id_ & 1;
 }
 
 bool
 graphplan::Proposition::is_negation_of(const Proposition& p) const
 {
-  return (name_.compare(p.name_) == 0) && (negated_ != p.negated_);
+  return (id_ ^ p.id_) == 1;
 }
 
 void
 graphplan::Proposition::set_negated(const bool& n)
 {
-  negated_ = n;
+  id_ = (id_ & ~1u) | (n ? 1 : 0);
 }
 
 void
 graphplan::Proposition::set_name(const std::string& n)
 {
-  name_ = n;
+  id_ = (Atom_Table::instance().intern(n) << 1) | (id_ & 1);
 }
 
 string
 graphplan::Proposition::to_string() const
 {
-  return name_ + (negated_ ? "_negated" : "");
+  return get_name() + (is_negated() ? "_negated" : "");
 }
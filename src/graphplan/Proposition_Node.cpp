@@ -31,37 +31,23 @@
 
 #include "graphplan/Proposition_Node.hpp"
 
-#include <set>
-
 using std::string;
-using std::set;
-
-graphplan::Proposition_Node::Proposition_Node(const Proposition& p) :
-  proposition_(p)
-{
-}
-
-graphplan::Proposition_Node::Proposition_Node(const Proposition_Node& p) :
-  proposition_(p.proposition_)
-{
-}
 
-void
-graphplan::Proposition_Node::add_supply(Action_Node* a)
+graphplan::Proposition_Node::Proposition_Node(const Proposition& p,
+  unsigned int level) :
+  proposition_(p), level_(level), literal_(p.get_id())
 {
-  supply_.insert(a);
 }
 
-void
-graphplan::Proposition_Node::add_cause(Action_Node* a)
+graphplan::Proposition_Node::Proposition_Node(const Proposition& p,
+  unsigned int level, unsigned int literal) :
+  proposition_(p), level_(level), literal_(literal)
 {
-  causes_.insert(a);
 }
 
-void
-graphplan::Proposition_Node::add_mutex(const Proposition_Node* p)
+graphplan::Proposition_Node::Proposition_Node(const Proposition_Node& p) :
+  proposition_(p.proposition_), level_(p.level_), literal_(p.literal_)
 {
-  mutex_.insert(p);
 }
 
 string
@@ -76,22 +62,16 @@ graphplan::Proposition_Node::get_proposition() const
   return proposition_;
 }
 
-const set<graphplan::Action_Node*>&
-graphplan::Proposition_Node::get_supply() const
-{
-  return supply_;
-}
-
-const set<graphplan::Action_Node*>&
-graphplan::Proposition_Node::get_causes() const
+unsigned int
+graphplan::Proposition_Node::get_level() const
 {
-  return causes_;
+  return level_;
 }
 
-const set<const graphplan::Proposition_Node*>&
-graphplan::Proposition_Node::get_mutex() const
+unsigned int
+graphplan::Proposition_Node::get_literal() const
 {
-  return mutex_;
+  return literal_;
 }
 
 bool
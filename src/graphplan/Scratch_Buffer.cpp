@@ -0,0 +1,126 @@
+/**
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2014 Anton Dukeman
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * @file Scratch_Buffer.cpp
+ * @author Anton Dukeman <anton.dukeman@gmail.com>
+ *
+ * Zeroed memory held on the heap or in a memory mapped scratch file
+ */
+
+#include "graphplan/Scratch_Buffer.hpp"
+
+#include <new>
+#include <vector>
+#include <utility>
+
+#include <sys/mman.h>
+#include <unistd.h>
+#include <stdlib.h>
+
+using std::size_t;
+using std::string;
+using std::vector;
+
+graphplan::Scratch_Buffer::Scratch_Buffer() :
+  data_(0), size_(0), mapped_(false)
+{
+}
+
+graphplan::Scratch_Buffer::Scratch_Buffer(size_t size,
+  const string& directory) :
+  data_(0), size_(size), mapped_(false)
+{
+  if(size == 0)
+    return;
+
+  if(directory.empty())
+  {
+    data_ = new char[size]();
+    return;
+  }
+
+  // a new file reads as zeros, unlinking it leaves only the mapping
+  string path = directory + "/graphplan.XXXXXX";
+  vector<char> name(path.begin(), path.end());
+  name.push_back('\0');
+  int fd = mkstemp(name.data());
+  if(fd < 0)
+    throw std::bad_alloc();
+  unlink(name.data());
+  void* p = MAP_FAILED;
+  if(ftruncate(fd, size) == 0)
+    p = mmap(0, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close(fd);
+  if(p == MAP_FAILED)
+    throw std::bad_alloc();
+
+  data_ = static_cast<char*>(p);
+  mapped_ = true;
+}
+
+graphplan::Scratch_Buffer::~Scratch_Buffer()
+{
+  release();
+}
+
+graphplan::Scratch_Buffer::Scratch_Buffer(Scratch_Buffer&& b) :
+  data_(0), size_(0), mapped_(false)
+{
+  swap(b);
+}
+
+graphplan::Scratch_Buffer&
+graphplan::Scratch_Buffer::operator=(Scratch_Buffer&& b)
+{
+  release();
+  swap(b);
+  return *this;
+}
+
+bool
+graphplan::Scratch_Buffer::is_mapped() const
+{
+  return mapped_;
+}
+
+void
+graphplan::Scratch_Buffer::swap(Scratch_Buffer& b)
+{
+  std::swap(data_, b.data_);
+  std::swap(size_, b.size_);
+  std::swap(mapped_, b.mapped_);
+}
+
+void
+graphplan::Scratch_Buffer::release()
+{
+  if(mapped_)
+    munmap(data_, size_);
+  else
+    delete [] data_;
+  data_ = 0;
+  size_ = 0;
+  mapped_ = false;
+}
@@ -0,0 +1,119 @@
+/**
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2014 Anton Dukeman
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * @file Thread_Pool.cpp
+ * @author Anton Dukeman <anton.dukeman@gmail.com>
+ *
+ * Fixed set of threads that run numbered tasks and wait for them all
+ */
+
+#include "graphplan/Thread_Pool.hpp"
+
+using std::mutex;
+using std::unique_lock;
+using std::lock_guard;
+
+graphplan::Thread_Pool::Thread_Pool(unsigned int threads) :
+  task_(0), count_(0), next_(0), busy_(0), batch_(0), stop_(false)
+{
+  for(unsigned int i = 1; i < threads; ++i)
+    workers_.push_back(std::thread(&Thread_Pool::work, this));
+}
+
+graphplan::Thread_Pool::~Thread_Pool()
+{
+  {
+    lock_guard<mutex> lock(mutex_);
+    stop_ = true;
+  }
+  start_.notify_all();
+  for(std::thread& t : workers_)
+    t.join();
+}
+
+unsigned int
+graphplan::Thread_Pool::size() const
+{
+  return workers_.size() + 1;
+}
+
+void
+graphplan::Thread_Pool::run(unsigned int count, const Task& task)
+{
+  lock_guard<mutex> batch(run_mutex_);
+
+  // nothing to share
+  if(workers_.empty() || count <= 1)
+  {
+    for(unsigned int i = 0; i < count; ++i)
+      task(i);
+    return;
+  }
+
+  {
+    lock_guard<mutex> lock(mutex_);
+    task_ = &task;
+    count_ = count;
+    next_ = 0;
+    busy_ = workers_.size();
+    ++batch_;
+  }
+  start_.notify_all();
+
+  // the caller works too, then waits for the others to finish theirs
+  drain();
+  unique_lock<mutex> lock(mutex_);
+  done_.wait(lock, [this] { return busy_ == 0; });
+  task_ = 0;
+}
+
+void
+graphplan::Thread_Pool::work()
+{
+  unsigned long seen = 0;
+  while(true)
+  {
+    {
+      unique_lock<mutex> lock(mutex_);
+      start_.wait(lock, [&] { return stop_ || batch_ != seen; });
+      if(stop_)
+        return;
+      seen = batch_;
+    }
+
+    drain();
+
+    lock_guard<mutex> lock(mutex_);
+    if(--busy_ == 0)
+      done_.notify_one();
+  }
+}
+
+void
+graphplan::Thread_Pool::drain()
+{
+  for(unsigned int i = next_++; i < count_; i = next_++)
+    (*task_)(i);
+}
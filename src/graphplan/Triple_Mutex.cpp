@@ -0,0 +1,157 @@
+/**
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2014 Anton Dukeman
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * @file Triple_Mutex.cpp
+ * @author Anton Dukeman <anton.dukeman@gmail.com>
+ *
+ * Triples of literal ids that cannot hold together in a level although no
+ * two of them are mutex, kept only for candidate triples chosen up front
+ */
+
+#include "graphplan/Triple_Mutex.hpp"
+
+#include <algorithm>
+#include <utility>
+
+using std::vector;
+
+const unsigned int graphplan::Triple_Mutex::npos;
+
+graphplan::Triple_Mutex::Triple_Mutex()
+{
+}
+
+void
+graphplan::Triple_Mutex::add_candidates(const vector<unsigned int>& literals)
+{
+  for(unsigned int i = 2; i < literals.size(); ++i)
+    for(unsigned int j = 1; j < i; ++j)
+      for(unsigned int k = 0; k < j; ++k)
+        triples_.push_back(Triple{{literals[k], literals[j], literals[i]}});
+}
+
+void
+graphplan::Triple_Mutex::build()
+{
+  std::sort(triples_.begin(), triples_.end());
+  triples_.erase(std::unique(triples_.begin(), triples_.end()),
+    triples_.end());
+  levels_.clear();
+}
+
+void
+graphplan::Triple_Mutex::clear()
+{
+  triples_.clear();
+  levels_.clear();
+}
+
+unsigned int
+graphplan::Triple_Mutex::size() const
+{
+  return triples_.size();
+}
+
+const graphplan::Triple_Mutex::Triple&
+graphplan::Triple_Mutex::get(unsigned int t) const
+{
+  return triples_[t];
+}
+
+unsigned int
+graphplan::Triple_Mutex::find(unsigned int a, unsigned int b,
+  unsigned int c) const
+{
+  Triple key = {{a, b, c}};
+  std::sort(key.begin(), key.end());
+  vector<Triple>::const_iterator it =
+    std::lower_bound(triples_.begin(), triples_.end(), key);
+  if(it == triples_.end() || *it != key)
+    return npos;
+  return it - triples_.begin();
+}
+
+unsigned int
+graphplan::Triple_Mutex::get_levels() const
+{
+  return levels_.size();
+}
+
+void
+graphplan::Triple_Mutex::clear_levels()
+{
+  levels_.clear();
+}
+
+void
+graphplan::Triple_Mutex::push_level(Bitset& mutex)
+{
+  levels_.push_back(Bitset());
+  std::swap(levels_.back(), mutex);
+  mutex.resize(triples_.size());
+}
+
+const graphplan::Bitset&
+graphplan::Triple_Mutex::last() const
+{
+  return levels_.back();
+}
+
+bool
+graphplan::Triple_Mutex::has_mutex(const vector<unsigned int>& literals,
+  unsigned int level) const
+{
+  return find_mutex(literals, level) != npos;
+}
+
+unsigned int
+graphplan::Triple_Mutex::find_mutex(const vector<unsigned int>& literals,
+  unsigned int level) const
+{
+  if(level >= levels_.size() || literals.size() < 3)
+    return npos;
+
+  // mutex triples are few, so look each one up in the literals
+  const Bitset& mutex = levels_[level];
+  for(unsigned int t = mutex.find_first(); t != Bitset::npos;
+    t = mutex.find_next(t))
+  {
+    const Triple& x = triples_[t];
+    if(std::binary_search(literals.begin(), literals.end(), x[0]) &&
+      std::binary_search(literals.begin(), literals.end(), x[1]) &&
+      std::binary_search(literals.begin(), literals.end(), x[2]))
+    {
+      return t;
+    }
+  }
+
+  return npos;
+}
+
+std::size_t
+graphplan::Triple_Mutex::count(unsigned int level) const
+{
+  return level < levels_.size() ? levels_[level].count() : 0;
+}
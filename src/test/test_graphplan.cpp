@@ -33,11 +33,28 @@
 #include <string>
 #include <sstream>
 #include <map>
+#include <algorithm>
+#include <thread>
 
 #include "graphplan/Graphplan.hpp"
 #include "graphplan/Graphplan_Parser.hpp"
 #include "graphplan/Action.hpp"
 #include "graphplan/Proposition.hpp"
+#include "graphplan/Atom_Table.hpp"
+#include "graphplan/Bitset.hpp"
+#include "graphplan/Mutex_Matrix.hpp"
+#include "graphplan/Leveled_Mutex.hpp"
+#include "graphplan/Fixed_Bitset.hpp"
+#include "graphplan/Layer_Engine.hpp"
+#include "graphplan/Mutex_Groups.hpp"
+#include "graphplan/Edge_Table.hpp"
+#include "graphplan/Node_Arena.hpp"
+#include "graphplan/Scratch_Buffer.hpp"
+#include "graphplan/Thread_Pool.hpp"
+#include "graphplan/Bit_Kernels.hpp"
+#include "graphplan/Batch_Graph.hpp"
+#include "graphplan/Triple_Mutex.hpp"
+#include "graphplan/Nogood_Trie.hpp"
 
 using std::cout;
 using std::endl;
@@ -45,6 +62,7 @@ using std::set;
 using std::string;
 using std::stringstream;
 using std::map;
+using std::vector;
 
 using namespace graphplan;
 
@@ -58,6 +76,519 @@ void test_proposition()
   assert(p_at_a == p_at_a);
   assert(p_at_a != p_not_at_a);
   assert(p_at_a.is_negation_of(p_not_at_a));
+  assert(!p_at_a.is_negation_of(p_not_at_b));
+  assert(p_at_a.get_atom() == p_not_at_a.get_atom());
+  assert(p_at_a.get_id() != p_not_at_a.get_id());
+  assert(p_at_a < p_not_at_a);
+  assert(p_not_at_a.get_name() == "x_at_a");
+  assert(p_not_at_a.to_string() == "x_at_a_negated");
+
+  Proposition p;
+  p.set_name("x_at_b");
+  assert(p == p_at_b);
+  p.set_negated();
+  assert(p == p_not_at_b);
+}
+
+void test_atom_table()
+{
+  Atom_Table& table = Atom_Table::instance();
+  unsigned int size = table.size();
+  unsigned int id = table.intern("test_atom_table_atom");
+  assert(table.size() == size + 1);
+  assert(table.intern("test_atom_table_atom") == id);
+  assert(table.size() == size + 1);
+  assert(table.get_name(id) == "test_atom_table_atom");
+  assert(table.get_name(p_at_a.get_atom()) == "x_at_a");
+}
+
+void test_bitset()
+{
+  Bitset a(100);
+  Bitset b;
+  assert(!a.any());
+  a.set(3);
+  a.set(70);
+  assert(a.test(3) && a.test(70) && !a.test(4));
+  assert(!a.test(1000));
+  assert(a.count() == 2);
+  assert(a.find_first() == 3);
+  assert(a.find_next(3) == 70);
+  assert(a.find_next(70) == Bitset::npos);
+
+  // b grows as needed and may be shorter than a
+  b.set(3);
+  assert(b.size() == 4);
+  assert(b.is_subset_of(a));
+  assert(!a.is_subset_of(b));
+  assert(a.intersects(b));
+  b.set(130);
+  assert(!b.is_subset_of(a));
+  b.reset(130);
+  assert(b.is_subset_of(a));
+  b |= a;
+  assert(b == a);
+  b.reset(70);
+  assert(b != a);
+  a &= b;
+  assert(a == b);
+  a.clear();
+  assert(!a.any() && a.size() == 100);
+}
+
+void test_bit_kernels()
+{
+  // every implementation agrees with the portable one, including tails
+  vector<const Bit_Kernels*> kernels = Bit_Kernels::supported();
+  assert(!kernels.empty() && &Bit_Kernels::best() == kernels.back());
+  vector<Bit_Kernels::Word> a(37, 0);
+  vector<Bit_Kernels::Word> b(37, 0);
+  for(unsigned int words = 0; words <= a.size(); ++words)
+  {
+    for(unsigned int bit = 0; bit < words * 64; bit += 61)
+    {
+      std::fill(a.begin(), a.end(), 0);
+      std::fill(b.begin(), b.end(), ~Bit_Kernels::Word(0));
+      a[bit / 64] = Bit_Kernels::Word(1) << (bit % 64);
+      for(const Bit_Kernels* k : kernels)
+      {
+        assert(k->is_subset(a.data(), b.data(), words));
+        assert(k->intersects(a.data(), b.data(), words));
+        assert(k->count(a.data(), words) == 1);
+      }
+      b[bit / 64] = ~a[bit / 64];
+      for(const Bit_Kernels* k : kernels)
+      {
+        assert(!k->is_subset(a.data(), b.data(), words));
+        assert(!k->intersects(a.data(), b.data(), words));
+        assert(k->count(b.data(), words) == words * 64 - 1);
+      }
+    }
+  }
+}
+
+void test_fixed_bitset()
+{
+  Fixed_Bitset<2> a;
+  assert(a.find_first() == Bitset::npos && a.word_count() == 2);
+
+  // bits past the capacity are dropped
+  Bitset b(200);
+  b.set(3);
+  b.set(100);
+  b.set(128);
+  Fixed_Bitset<2> c(b);
+  assert(c.find_first() == 3 && c.find_next(3) == 100);
+  assert(c.find_next(100) == Bitset::npos);
+  assert(c.data()[0] == b.data()[0] && c.data()[1] == b.data()[1]);
+}
+
+void test_layer_engine()
+{
+  // action 0 needs 1 and 2, action 1 needs 3
+  vector<Bitset> preconditions(2, Bitset(10));
+  preconditions[0].set(1);
+  preconditions[0].set(2);
+  preconditions[1].set(3);
+  Bitset goals(10);
+  goals.set(2);
+  goals.set(3);
+  Layer_Engine fixed(preconditions, 10);
+  Layer_Engine dynamic(preconditions, 1000);
+  const Layer_Engine* engines[] = { &fixed, &dynamic };
+  for(const Layer_Engine* e : engines)
+  {
+    Bitset layer(10);
+    layer.set(1);
+    layer.set(2);
+    layer.set(3);
+    Mutex_Matrix mutex(10);
+    vector<unsigned int> triggered(1, 0);
+    triggered.push_back(1);
+    vector<unsigned int> applicable;
+    e->find_applicable(triggered, mutex, applicable);
+    assert(applicable.size() == 2 && triggered.empty());
+    assert(e->has_goals(goals, layer, mutex));
+
+    // actions with mutex preconditions stay triggered
+    mutex.set(1, 2);
+    triggered.push_back(0);
+    triggered.push_back(1);
+    applicable.clear();
+    e->find_applicable(triggered, mutex, applicable);
+    assert(applicable.size() == 1 && applicable[0] == 1);
+    assert(triggered.size() == 1 && triggered[0] == 0);
+    layer.reset(3);
+    assert(!e->has_goals(goals, layer, mutex));
+  }
+  assert(fixed.get_capacity() == 64 && dynamic.get_capacity() == 0);
+  assert(Layer_Engine(preconditions, 65).get_capacity() == 128);
+  assert(Layer_Engine(preconditions, 256).get_capacity() == 256);
+  assert(Layer_Engine().get_capacity() == 0);
+
+  // goals past the end of the layer are never in it
+  Bitset short_layer(2);
+  short_layer.set(1);
+  assert(!fixed.has_goals(goals, short_layer, Mutex_Matrix(10)));
+}
+
+void test_mutex_groups()
+{
+  // a truck moves between locations 0, 2 and 4, a package at 6 is loaded
+  // into it at location 0 and becomes 8
+  Mutex_Groups::Literal_Table preconditions;
+  Mutex_Groups::Literal_Table effects;
+  Mutex_Groups::Literal_Table deletes;
+  unsigned int action = 0;
+  for(unsigned int from = 0; from < 6; from += 2)
+  {
+    for(unsigned int to = 0; to < 6; to += 2)
+    {
+      if(from == to)
+        continue;
+      preconditions.add(action, from);
+      effects.add(action, to);
+      deletes.add(action, from);
+      ++action;
+    }
+  }
+  preconditions.add(action, 0);
+  preconditions.add(action, 6);
+  effects.add(action, 8);
+  deletes.add(action, 6);
+  ++action;
+  preconditions.build(action);
+  effects.build(action);
+  deletes.build(action);
+
+  vector<unsigned int> initial;
+  initial.push_back(2);
+  initial.push_back(6);
+  Mutex_Groups groups;
+  groups.synthesize(10, initial, preconditions, effects, deletes, action);
+  assert(groups.size() == 2);
+  assert(groups.same_group(0, 2) && groups.same_group(4, 2));
+  assert(groups.same_group(6, 8));
+  assert(!groups.same_group(0, 6) && !groups.same_group(0, 0));
+  assert(groups.get_group_of(1) == Mutex_Groups::npos);
+  assert(groups.count_pairs() == 4);
+  assert(groups.get_group_of(4) == groups.get_group_of(0));
+  assert(groups.get_group_of(8) != groups.get_group_of(0));
+
+  // a second truck at the same location breaks the invariant
+  initial.push_back(0);
+  groups.synthesize(10, initial, preconditions, effects, deletes, action);
+  assert(!groups.same_group(0, 2));
+}
+
+void test_scratch_buffer()
+{
+  Scratch_Buffer heap(100);
+  Scratch_Buffer mapped(100, "/tmp");
+  assert(!heap.is_mapped() && mapped.is_mapped());
+  assert(heap.size() == 100 && mapped.size() == 100);
+  assert(heap.data()[99] == 0 && mapped.data()[99] == 0);
+  mapped.data()[99] = 7;
+
+  // moving keeps the memory
+  char* data = mapped.data();
+  Scratch_Buffer moved(std::move(mapped));
+  assert(moved.data() == data && moved.data()[99] == 7);
+  assert(mapped.data() == 0 && mapped.size() == 0 && !mapped.is_mapped());
+}
+
+void test_thread_pool()
+{
+  Thread_Pool pool(4);
+  assert(pool.size() == 4);
+  vector<unsigned int> done(100, 0);
+  for(unsigned int batch = 1; batch <= 3; ++batch)
+  {
+    pool.run(done.size(), [&](unsigned int i) { done[i] += i; });
+    for(unsigned int i = 0; i < done.size(); ++i)
+      assert(done[i] == batch * i);
+  }
+  assert(Thread_Pool().size() == 1);
+}
+
+void test_mutex_matrix()
+{
+  Mutex_Matrix m(200);
+  assert(m.count() == 0);
+  m.set(3, 150);
+  m.set(70, 65);
+  assert(m.test(3, 150) && m.test(150, 3));
+  assert(m.test(65, 70));
+  assert(!m.test(3, 3) && !m.test(3, 4));
+  assert(m.count() == 2);
+
+  // pairs are found from the row of their larger member
+  m.set(150, 130);
+  assert(m.find_first(150) == 3 && m.find_next(150, 3) == 130);
+  assert(m.find_next(150, 130) == Bitset::npos);
+  assert(m.find_first(70) == 65 && m.find_first(3) == Bitset::npos);
+  m.resize(200);
+  m.set(3, 150);
+  m.set(70, 65);
+
+  Bitset s;
+  s.set(3);
+  s.set(4);
+  assert(!m.has_mutex(s));
+  assert(m.intersects(150, s));
+  assert(!m.intersects(70, s));
+  s.set(150);
+  assert(m.has_mutex(s));
+  s.reset(150);
+  s.set(70);
+  assert(m.intersects(65, s));
+  assert(!m.has_mutex(s));
+  s.set(65);
+  assert(m.has_mutex(s));
+
+  // every member on either side of the row has to be mutex
+  Bitset c(200);
+  assert(m.covers(3, c));
+  c.set(150);
+  assert(m.covers(3, c) && m.covers(150, Bitset(200)));
+  m.set(150, 130);
+  m.set(150, 199);
+  c.reset(150);
+  c.set(3);
+  c.set(130);
+  assert(m.covers(150, c));
+  c.set(199);
+  assert(m.covers(150, c));
+  c.set(150);
+  assert(!m.covers(150, c));
+  c.reset(150);
+  c.set(4);
+  assert(!m.covers(150, c));
+
+  // a matrix in a scratch file starts clear after every resize
+  Mutex_Matrix mapped(200, "/tmp");
+  mapped.set(3, 150);
+  assert(mapped.test(150, 3) && mapped.count() == 1);
+  mapped.resize(300);
+  assert(mapped.count() == 0 && !mapped.test(150, 3));
+}
+
+void test_edge_table()
+{
+  Edge_Table<unsigned int> edges;
+  assert(edges.get(0).empty());
+  edges.add(2, 7);
+  edges.add(0, 5);
+  edges.add(2, 3);
+  edges.build(4);
+  assert(edges.size() == 3);
+  assert(edges.get(0).size() == 1 && *edges.get(0).begin() == 5);
+  assert(edges.get(1).empty());
+  assert(edges.get(2).size() == 2);
+  assert(edges.get(2).begin()[0] == 3 && edges.get(2).begin()[1] == 7);
+  assert(edges.get(3).empty());
+  assert(edges.get(4).empty());
+
+  // later builds keep the earlier edges
+  edges.add(2, 1);
+  edges.build(4);
+  assert(edges.size() == 4);
+  assert(edges.get(2).size() == 3 && edges.get(2).begin()[0] == 1);
+  assert(edges.get(0).size() == 1);
+
+  // staged rows leave the table as it was until swapped in
+  Edge_Table<unsigned int> staged;
+  edges.add(3, 9);
+  edges.stage(4, staged);
+  assert(edges.size() == 4 && edges.get(3).empty());
+  assert(staged.size() == 5 && *staged.get(3).begin() == 9);
+  edges.swap(staged);
+  assert(edges.size() == 5 && edges.get(2).size() == 3);
+
+  // staging again reuses the swapped out table and merges new edges in
+  edges.add(2, 5);
+  edges.add(2, 0);
+  edges.stage(4, staged);
+  assert(staged.size() == 7 && staged.get(3).size() == 1);
+  const unsigned int merged[] = { 0, 1, 3, 5, 7 };
+  assert(staged.get(2).size() == 5);
+  assert(std::equal(merged, merged + 5, staged.get(2).begin()));
+}
+
+void test_leveled_mutex()
+{
+  Leveled_Mutex m(100);
+  Mutex_Matrix level(100);
+  level.set(1, 2);
+  level.set(3, 4);
+  m.push_level(level);
+  assert(level.size() == 100 && level.count() == 0);
+  assert(m.get_levels() == 1 && m.last().count() == 2);
+
+  // 3 and 4 stop being mutex in level 1, 5 appears mutex with 1
+  level.set(1, 2);
+  level.set(1, 5);
+  m.push_level(level);
+  level.set(1, 5);
+  m.push_level(level);
+  assert(m.get_levels() == 3 && m.count_ended() == 2);
+  assert(m.test(3, 4, 0) && !m.test(3, 4, 1) && !m.test(4, 3, 2));
+  assert(m.test(2, 1, 0) && m.test(1, 2, 1) && !m.test(1, 2, 2));
+  assert(m.test(1, 5, 1) && m.test(1, 5, 2) && !m.test(1, 5, 3));
+
+  Bitset s;
+  s.set(2);
+  s.set(5);
+  assert(m.intersects(1, s, 1) && m.intersects(1, s, 2));
+  s.reset(5);
+  assert(m.intersects(1, s, 1) && !m.intersects(1, s, 2));
+
+  // ended pairs are found from the row of either member, words apart
+  level.set(1, 90);
+  level.set(70, 90);
+  m.push_level(level);
+  m.push_level(level);
+  assert(m.count_ended() == 5 && m.test(90, 1, 3) && !m.test(90, 1, 4));
+  s.clear();
+  s.set(90);
+  assert(m.intersects(1, s, 3) && m.intersects(70, s, 3));
+  assert(!m.intersects(1, s, 4) && !m.intersects(3, s, 3));
+  s.set(70);
+  assert(m.has_mutex(s, 3) && !m.has_mutex(s, 4));
+  s.reset(90);
+  s.set(4);
+  assert(!m.has_mutex(s, 0) && !m.has_mutex(s, 4));
+  s.set(3);
+  assert(m.has_mutex(s, 0) && !m.has_mutex(s, 1));
+}
+
+void test_triple_mutex()
+{
+  Triple_Mutex t;
+  t.add_candidates({1, 4, 6, 9});
+  t.add_candidates({1, 4, 6});
+  t.build();
+  assert(t.size() == 4);
+  assert(t.find(6, 1, 4) != Triple_Mutex::npos);
+  assert(t.find(1, 4, 7) == Triple_Mutex::npos);
+
+  // 1, 4 and 9 are mutex in level 1 only
+  Bitset level(t.size());
+  t.push_level(level);
+  level.set(t.find(1, 4, 9));
+  t.push_level(level);
+  t.push_level(level);
+  assert(t.get_levels() == 3 && t.count(1) == 1 && t.last().count() == 0);
+  assert(t.has_mutex({0, 1, 4, 9}, 1));
+  assert(!t.has_mutex({0, 1, 4, 9}, 0) && !t.has_mutex({0, 1, 4, 9}, 2));
+  assert(!t.has_mutex({1, 4, 6}, 1));
+  assert(t.find_mutex({0, 1, 4, 9}, 1) == t.find(1, 4, 9));
+  assert(t.find_mutex({0, 1, 4, 9}, 2) == Triple_Mutex::npos);
+}
+
+void test_nogood_trie()
+{
+  Nogood_Trie t;
+  assert(!t.contains_subset(2, {1, 2, 3}));
+  t.insert(2, {3, 5, 8});
+  t.insert(2, {3, 6});
+  t.insert(1, {2});
+  assert(t.size(2) == 2 && t.size(1) == 1 && t.size(0) == 0);
+  assert(t.contains_subset(2, {1, 3, 5, 7, 8}));
+  assert(t.contains_subset(2, {3, 6}));
+  assert(!t.contains_subset(2, {3, 5, 7}));
+  assert(!t.contains_subset(1, {3, 6}) && t.contains_subset(1, {0, 2}));
+  Nogood_Trie::Nogood found;
+  assert(t.get_subset(2, {1, 3, 5, 7, 8}, found));
+  assert(found == Nogood_Trie::Nogood({3, 5, 8}));
+  assert(!t.get_subset(2, {3, 5, 7}, found));
+
+  // a smaller nogood replaces the ones holding it
+  t.insert(2, {3});
+  assert(t.size(2) == 1 && t.get_insert_count(2) == 3);
+  assert(t.contains_subset(2, {3, 9}));
+
+  // over the bound the least recently used go first
+  Nogood_Trie bounded;
+  for(unsigned int i = 0; i < 100; ++i)
+    bounded.insert(0, {i, i + 1000});
+  std::size_t memory = bounded.get_memory();
+  bounded.set_limit(memory / 2);
+  assert(bounded.get_memory() <= memory / 2);
+  assert(bounded.get_evict_count() != 0);
+  assert(bounded.size(0) + bounded.get_evict_count() == 100);
+  assert(bounded.contains_subset(0, {99, 1099}));
+  assert(!bounded.contains_subset(0, {0, 1000}));
+  t.clear();
+  assert(t.size(2) == 0 && !t.contains_subset(2, {3}));
+
+  // nogoods of the kept level are never dropped, even the oldest
+  Nogood_Trie kept;
+  kept.keep_level(1);
+  kept.insert(1, {7});
+  for(unsigned int i = 0; i < 100; ++i)
+    kept.insert(0, {i, i + 1000});
+  kept.set_limit(kept.get_memory() / 2);
+  assert(kept.get_evict_count() != 0);
+  assert(kept.size(1) == 1 && kept.contains_subset(1, {7}));
+  kept.clear();
+  assert(kept.get_evict_count() == 0);
+
+  // a kept level over the bound holds everything, others still go once it
+  // has grown by a quarter
+  kept.keep_level(1);
+  kept.set_limit(64);
+  for(unsigned int i = 0; i < 100; ++i)
+    kept.insert(1, {i});
+  assert(kept.size(1) == 100 && kept.get_evict_count() == 0);
+  kept.insert(0, {1, 2});
+  assert(kept.size(0) == 1);
+  for(unsigned int i = 100; i < 200 && kept.size(0) != 0; ++i)
+    kept.insert(1, {i});
+  assert(kept.size(0) == 0 && kept.get_evict_count() == 1);
+  assert(kept.size(1) > 100 && kept.size(1) < 200);
+}
+
+void test_node_arena()
+{
+  Node_Arena arena(64);
+  assert(arena.get_used() == 0 && arena.get_capacity() == 0);
+  Proposition_Node* pn = arena.create<Proposition_Node>(p_at_a, 3);
+  assert(pn->instance_of(p_at_a) && pn->get_level() == 3);
+  for(unsigned int i = 0; i < 20; ++i)
+    arena.create<Proposition_Node>(p_at_b);
+  assert(arena.get_used() >= 21 * sizeof(Proposition_Node));
+  assert(arena.get_high_water_mark() == arena.get_used());
+
+  // blocks are kept and reused after a reset
+  std::size_t capacity = arena.get_capacity();
+  std::size_t high_water = arena.get_high_water_mark();
+  arena.reset();
+  assert(arena.get_used() == 0);
+  arena.create<Proposition_Node>(p_at_b);
+  assert(arena.get_capacity() == capacity);
+  assert(arena.get_high_water_mark() == high_water);
+
+  // oversized requests get their own block
+  assert(arena.allocate(1000, 8) != 0);
+  assert(arena.get_capacity() >= capacity + 1000);
+
+  // blocks in scratch files are large since each is one mapping
+  Node_Arena mapped(64);
+  mapped.set_scratch_directory("/tmp");
+  pn = mapped.create<Proposition_Node>(p_at_a, 3);
+  assert(pn->instance_of(p_at_a) && pn->get_level() == 3);
+  assert(mapped.get_capacity() > 64);
+
+  // blocks of the old backing go once nothing lives in them
+  arena.set_scratch_directory("/tmp");
+  arena.reset();
+  assert(arena.get_capacity() == 0);
+  arena.create<Proposition_Node>(p_at_b);
+  assert(arena.get_capacity() > 64);
+  mapped.reset();
+  mapped.set_scratch_directory("");
+  assert(mapped.get_capacity() == 0);
 }
 
 void test_action()
@@ -81,6 +612,12 @@ void test_proposition_node()
   assert(pn_at_b.instance_of(p_at_b));
   assert(!pn_at_b.instance_of(p_at_a));
   assert(pn_at_b.get_name() == "x_at_b");
+
+  // standalone nodes use the interned id, compiled ones a dense literal id
+  assert(pn_at_a.get_literal() == p_at_a.get_id());
+  Proposition_Node pn_dense(p_at_b, 2, 1);
+  assert(pn_dense.instance_of(p_at_b) && pn_dense.get_literal() == 1);
+  assert(pn_dense.get_level() == 2);
 }
 
 void test_action_node()
@@ -92,6 +629,11 @@ void test_action_node()
 
   Action_Node an_a_to_b(a_a_to_b);
   assert(an_a_to_b.is_instance_of(a_a_to_b));
+  assert(&an_a_to_b.get_action() == &a_a_to_b);
+  assert(!Action_Node::is_noop(an_a_to_b.get_id()));
+  assert(Action_Node::is_noop(Action_Node::noop_id(0)));
+  assert(Action_Node::noop_id(0) != Action_Node::noop_id(1));
+  assert((Action_Node::noop_id(5) & ~Action_Node::NOOP) == 5);
 }
 
 void test_partial_order_plan()
@@ -105,6 +647,7 @@ void test_partial_order_plan()
   plan.add_action(0, a_a_to_b);
   plan.add_action(0, a_b_to_c);
   plan.add_action(1, a_a_to_b);
+  assert(*plan.get_actions(1).begin() == a_a_to_b);
   stringstream expected;
   expected << "Stage 0" << endl;
   expected << "\tmove_a_to_b" << endl;
@@ -129,7 +672,7 @@ void test_graphplan()
   set<Proposition_Node*> props;
 
   // case 1: not goal
-  map<const Proposition_Node*, Action_Node*> actions;
+  vector<Graphplan::Supporters> actions;
   assert(!g.goal_check(props, actions));
 
   // case 2: has goal
@@ -142,11 +685,13 @@ void test_graphplan()
   props.insert(&pn_at_a);
   assert(g.goal_check(props, actions));
 
-  // case 4: mutex between them
-  pn_at_a.add_mutex(&pn_at_b);
-  pn_at_b.add_mutex(&pn_at_a);
+  // case 4: mutex between them, in the graph or in a matrix of their own
+  Mutex_Matrix mutex(2 * Atom_Table::instance().size());
+  mutex.set(p_at_a.get_id(), p_at_b.get_id());
+  assert(g.plan() == 1);
   g.add_goal(p_at_a);
   assert(!g.goal_check(props, actions));
+  assert(!g.goal_check(props, mutex, actions));
 
   // attempt a plan
   Graphplan test;
@@ -154,6 +699,40 @@ void test_graphplan()
   test.add_goal(p_at_b);
   test.add_action(a_a_to_b);
   assert(test.plan() == 1);
+  assert(test.get_layer_engine()->get_capacity() == 64);
+
+  // a goal that never appears is unsolvable once the graph levels off
+  Graphplan never = test.fork();
+  never.clear_goals();
+  never.add_goal(p_not_at_b);
+  assert(never.plan() == 2 && never.get_leveled_off() == 1);
+  assert(never.get_status() == Graphplan::UNSOLVABLE);
+
+  // larger problems fall back to dynamic layers
+  Graphplan wide;
+  Proposition p_wide_goal("wide_goal");
+  Action a_wide("wide");
+  for(unsigned int i = 0; i < 200; ++i)
+  {
+    stringstream name;
+    name << "wide_" << i;
+    Proposition p(name.str());
+    wide.add_starting(p);
+    a_wide.add_precondition(p);
+  }
+  a_wide.add_effect(p_wide_goal);
+  wide.add_action(a_wide);
+  wide.add_goal(p_wide_goal);
+  assert(wide.plan() == 1);
+  assert(wide.get_layer_engine()->get_capacity() == 0);
+
+  // literals are numbered per problem, so interning many atoms elsewhere
+  // does not widen a small one
+  Graphplan small = test.fork();
+  small.add_action(Action("noop"));
+  assert(Atom_Table::instance().size() > 64);
+  assert(small.plan() == 1);
+  assert(small.get_layer_engine()->get_capacity() == 64);
 
   // attempt another plan
   Graphplan test_2;
@@ -167,6 +746,179 @@ void test_graphplan()
   test_2.add_action(a_a_to_b);
   test_2.add_action(a_b_to_c);
   assert(test_2.plan() == 2);
+  assert(test_2.get_status() == Graphplan::FOUND);
+
+  // forks share the expanded graph until one changes it
+  Graphplan shared = test_2.fork();
+  assert(&shared.get_arena() == &test_2.get_arena());
+  shared.clear_goals();
+  shared.add_goal(p_at_b);
+  assert(shared.plan() == 1);
+  shared.clear_goals();
+  shared.add_goal(p_at_c);
+  shared.remove_action(a_b_to_c);
+  unsigned int levels = shared.plan();
+  assert(shared.get_status() == Graphplan::UNSOLVABLE);
+  assert(shared.get_leveled_off() < levels);
+  assert(shared.get_nogood_count(shared.get_leveled_off()) > 0);
+  assert(shared.get_nogood_memory() > 0);
+  assert(shared.get_nogood_limit() == Nogood_Trie::NO_LIMIT);
+  assert(shared.plan(1) == 1);
+  assert(shared.get_status() == Graphplan::BUDGET_EXHAUSTED);
+  assert(&shared.get_arena() == &test_2.get_arena());
+  assert(test_2.plan() == 2);
+  Graphplan detached = test_2.fork();
+  detached.add_action(Action("move_c_to_a"));
+  assert(detached.plan() == 2);
+  assert(&detached.get_arena() != &test_2.get_arena());
+
+  // forks sharing a graph may plan from different threads, taking turns
+  Graphplan racing = test_2.fork();
+  racing.add_action(Action("move_c_to_b"));
+  assert(racing.plan(1) == 1);
+  Graphplan racing_b = racing.fork();
+  racing_b.clear_goals();
+  racing_b.add_goal(p_at_b);
+  unsigned int racing_levels = 0;
+  unsigned int racing_b_levels = 0;
+  std::thread first([&] { racing_levels = racing.plan(); });
+  std::thread second([&] { racing_b_levels = racing_b.plan(); });
+  first.join();
+  second.join();
+  assert(racing_levels == 2 && racing_b_levels == 1);
+  assert(&racing.get_arena() == &racing_b.get_arena());
+
+  // negated effects are only deletes under the closed world assumption
+  Graphplan closed_2;
+  closed_2.set_closed_world();
+  closed_2.add_starting(p_at_a);
+  closed_2.add_goal(p_at_c);
+  closed_2.add_action(a_a_to_b);
+  closed_2.add_action(a_b_to_c);
+  Partial_Order_Plan closed_plan;
+  assert(closed_2.is_closed_world() && !test_2.is_closed_world());
+  assert(closed_2.plan(5, &closed_plan) == 2);
+  assert(*closed_plan.get_actions(0).begin() == a_a_to_b);
+  assert(*closed_plan.get_actions(1).begin() == a_b_to_c);
+  assert(closed_2.get_arena().get_used() < test_2.get_arena().get_used());
+
+  // the graph can live in memory mapped files
+  Graphplan mapped_2 = test_2.fork();
+  mapped_2.set_scratch_directory("/tmp");
+  Partial_Order_Plan mapped_plan;
+  assert(mapped_2.plan(5, &mapped_plan) == 2);
+  assert(*mapped_plan.get_actions(1).begin() == a_b_to_c);
+  assert(&mapped_2.get_arena() != &test_2.get_arena());
+  assert(mapped_2.get_arena().get_scratch_directory() == "/tmp");
+
+  // levels built by several threads give the same plans
+  Graphplan threaded = test_2.fork();
+  threaded.set_threads(4);
+  threaded.add_action(Action("move_c_to_a"));
+  Partial_Order_Plan threaded_plan;
+  assert(threaded.get_threads() == 4);
+  assert(threaded.plan(5, &threaded_plan) == 2);
+  assert(*threaded_plan.get_actions(0).begin() == a_a_to_b);
+  assert(*threaded_plan.get_actions(1).begin() == a_b_to_c);
+
+  // levels built while the level before is searched give the same plans
+  Graphplan pipelined;
+  pipelined.set_pipelined();
+  pipelined.add_starting(p_at_a);
+  pipelined.add_goal(p_at_c);
+  pipelined.add_action(a_a_to_b);
+  pipelined.add_action(a_b_to_c);
+  pipelined.add_action(Action("move_c_to_a"));
+  Partial_Order_Plan pipelined_plan;
+  assert(pipelined.is_pipelined() && !test_2.is_pipelined());
+  assert(pipelined.plan(5, &pipelined_plan) == 2);
+  assert(*pipelined_plan.get_actions(0).begin() == a_a_to_b);
+  assert(*pipelined_plan.get_actions(1).begin() == a_b_to_c);
+
+  // two tokens make any two of three goals but never all three
+  Graphplan tokens;
+  Proposition token_1("token_1");
+  Proposition token_2("token_2");
+  tokens.add_starting(token_1);
+  tokens.add_starting(token_2);
+  const char* made[] = {"made_a", "made_b", "made_c"};
+  for(const char* name : made)
+  {
+    tokens.add_goal(Proposition(name));
+    for(const Proposition& token : {token_1, token_2})
+    {
+      Action make(string(name) + "_with_" + token.get_name());
+      make.add_precondition(token);
+      make.add_effect(Proposition(name));
+      make.add_effect(Proposition(token.get_name(), true));
+      tokens.add_action(make);
+    }
+  }
+  Graphplan tokens_3 = tokens.fork();
+  tokens_3.set_triple_mutexes();
+  assert(tokens_3.has_triple_mutexes() && !tokens.has_triple_mutexes());
+  tokens.plan(10);
+  tokens_3.plan(10);
+  assert(tokens.get_status() == Graphplan::UNSOLVABLE);
+  assert(tokens_3.get_status() == Graphplan::UNSOLVABLE);
+  assert(tokens.get_triple_count() == 0);
+  assert(tokens_3.get_triple_count() == 1);
+  assert(tokens_3.get_triple_mutex_count(0) == 0);
+  assert(tokens_3.get_triple_mutex_count(1) == 1);
+  assert(tokens.get_triple_prune_count() == 0);
+  assert(tokens_3.get_triple_prune_count() != 0);
+
+  // a bound small enough to drop every other nogood still levels off
+  Graphplan tokens_bounded = tokens.fork();
+  tokens_bounded.set_nogood_limit(16);
+  assert(tokens_bounded.plan(2000) < 10);
+  assert(tokens_bounded.get_status() == Graphplan::UNSOLVABLE);
+
+  // with two goals the same plan is found either way
+  tokens_3.clear_goals();
+  tokens_3.add_goal(Proposition("made_a"));
+  tokens_3.add_goal(Proposition("made_b"));
+  assert(tokens_3.plan(10) == 1);
+
+  // one token makes either of two goals at a time, with backjumping spare
+  // goals are not to blame and their other causes are skipped
+  Graphplan spare;
+  Proposition token("token");
+  spare.add_starting(token);
+  const char* spares[] = {"spare_a", "spare_b", "spare_c"};
+  for(const char* name : {"made_a", "made_b"})
+  {
+    spare.add_goal(Proposition(name));
+    Action make(string("make_") + name);
+    make.add_precondition(token);
+    make.add_effect(Proposition(name));
+    make.add_effect(Proposition("token", true));
+    spare.add_action(make);
+    Action give(string("give_back_") + name);
+    give.add_precondition(Proposition(name));
+    give.add_effect(token);
+    spare.add_action(give);
+  }
+  for(const char* name : spares)
+  {
+    spare.add_goal(Proposition(name));
+    for(const char* way : {"_by_hand", "_by_cart"})
+    {
+      Action get(string("get_") + name + way);
+      get.add_effect(Proposition(name));
+      spare.add_action(get);
+    }
+  }
+  Graphplan spare_jumps = spare.fork();
+  spare_jumps.set_backjumping();
+  assert(spare_jumps.has_backjumping() && !spare.has_backjumping());
+  Partial_Order_Plan spare_plan;
+  Partial_Order_Plan spare_jumps_plan;
+  assert(spare.plan(10, &spare_plan) == 3);
+  assert(spare.get_backjump_count() == 0);
+  assert(spare_jumps.plan(10, &spare_jumps_plan) == 3);
+  assert(spare_jumps.get_backjump_count() != 0);
+  assert(spare_plan.to_string() == spare_jumps_plan.to_string());
 
   // birthday dinner example
   Graphplan birthday;
@@ -206,6 +958,17 @@ void test_graphplan()
   birthday.add_action(dolly);
   assert(birthday.plan(10) == 2);
 
+  // planning again reuses the memory of the first graph
+  std::size_t capacity = birthday.get_arena().get_capacity();
+  std::size_t high_water = birthday.get_arena().get_high_water_mark();
+  assert(birthday.plan(10) == 2);
+  assert(birthday.get_arena().get_capacity() == capacity);
+  assert(birthday.get_arena().get_high_water_mark() == high_water);
+
+  // negated goals are still stored under the closed world assumption
+  birthday.set_closed_world();
+  assert(birthday.plan(10) == 2);
+
   // test parser with previous problem
   Graphplan_Parser gp;
   Graphplan birthday_text;
@@ -233,16 +996,111 @@ void test_graphplan()
   cake.add_action(bake_cake);
   Partial_Order_Plan p;
   assert(cake.plan(5, &p) == 2);
+  assert(p.get_actions(0).size() == 1);
+  assert(*p.get_actions(0).begin() == eat_cake);
+  assert(p.get_actions(1).size() == 1);
+  assert(*p.get_actions(1).begin() == bake_cake);
+
+  // a plan keeps its actions after the graph that found it is gone
+  Partial_Order_Plan kept;
+  {
+    Graphplan scoped = cake.fork();
+    scoped.add_action(Action("nap"));
+    assert(scoped.plan(5, &kept) == 2);
+  }
+  assert(*kept.get_actions(0).begin() == eat_cake);
+  assert(kept.to_string() == p.to_string());
+}
+
+void test_batch_graph()
+{
+  Proposition have_cake("have_cake");
+  Proposition not_have_cake("have_cake", true);
+  Proposition eaten_cake("eaten_cake");
+  Proposition not_eaten_cake("eaten_cake", true);
+  Action eat_cake("eat_cake");
+  eat_cake.add_precondition(have_cake);
+  eat_cake.add_effect(not_have_cake);
+  eat_cake.add_effect(eaten_cake);
+  Action bake_cake("bake_cake");
+  bake_cake.add_precondition(not_have_cake);
+  bake_cake.add_effect(have_cake);
+
+  // each lane starts somewhere else, the last has nothing to start from
+  Batch_Graph batch;
+  batch.add_action(eat_cake);
+  batch.add_action(bake_cake);
+  batch.add_goal(have_cake);
+  batch.add_goal(eaten_cake);
+  set<Proposition> full = {have_cake, not_eaten_cake};
+  set<Proposition> empty = {not_have_cake, not_eaten_cake};
+  assert(batch.add_instance(full) == 0);
+  assert(batch.add_instance(empty) == 1);
+  assert(batch.add_instance(set<Proposition>()) == 2);
+  assert(batch.get_instance_count() == 3);
+  batch.expand();
+
+  // goals are all there in level 1 but only apart in level 2
+  assert(batch.get_goal_level(0) == 2);
+  assert(batch.get_goal_level(1) == 3);
+  assert(batch.get_goal_level(2) == Batch_Graph::npos);
+  assert(batch.get_leveled_off(2) == 0);
+  assert(batch.get_reached(have_cake) == 3);
+  assert(batch.get_reached(eaten_cake) == 3);
+  assert(batch.get_mutex(have_cake, not_have_cake) == 3);
+
+  // lanes agree with planning each problem on its own
+  Graphplan cake;
+  for(const Proposition& p : full)
+    cake.add_starting(p);
+  cake.add_goal(have_cake);
+  cake.add_goal(eaten_cake);
+  cake.add_action(eat_cake);
+  cake.add_action(bake_cake);
+  assert(cake.plan() == 2);
+  Graphplan nothing;
+  nothing.add_goal(have_cake);
+  nothing.add_action(eat_cake);
+  nothing.add_action(bake_cake);
+  nothing.plan();
+  assert(nothing.get_status() == Graphplan::UNSOLVABLE);
+  assert(nothing.get_leveled_off() == batch.get_leveled_off(2));
+
+  // a batch holds one problem per bit
+  Batch_Graph wide;
+  for(unsigned int lane = 0; lane < Batch_Graph::LANES; ++lane)
+    assert(wide.add_instance(full) == lane);
+  assert(wide.add_instance(full) == Batch_Graph::npos);
+  wide.add_action(eat_cake);
+  wide.add_goal(eaten_cake);
+  assert(wide.expand() == 2);
+  assert(wide.get_reached(eaten_cake) == ~Batch_Graph::Lanes(0));
+  assert(wide.get_goal_level(63) == 1);
 }
 
 int main()
 {
   test_proposition();
+  test_atom_table();
+  test_bitset();
+  test_scratch_buffer();
+  test_thread_pool();
+  test_mutex_matrix();
+  test_edge_table();
+  test_bit_kernels();
+  test_fixed_bitset();
+  test_layer_engine();
+  test_mutex_groups();
+  test_leveled_mutex();
+  test_triple_mutex();
+  test_nogood_trie();
+  test_node_arena();
   test_action();
   test_proposition_node();
   test_action_node();
   test_partial_order_plan();
   test_graphplan();
+  test_batch_graph();
 
   return 0;
 }